@@ -33,6 +33,11 @@ let package = Package(
         .product(name: "Logging", package: "swift-log"),
       ]),
     .target(name: "Fixtures", dependencies: ["ShapeTree"]),
+    .executableTarget(
+      name: "Benchmarks",
+      dependencies: ["ShapeTree", "Fixtures", "Wayland", "CAllocationCounter"],
+      swiftSettings: swiftSettings
+    ),
     .target(
       name: "Wayland",
       dependencies: [
@@ -53,7 +58,7 @@ let package = Package(
     .testTarget(
       name: "WaylandTests",
       dependencies: [
-        "Wayland", "SwiftWayland", "Fixtures",
+        "Wayland", "SwiftWayland", "Fixtures", "CAllocationCounter",
       ],
       swiftSettings: swiftSettings),
     // Linked Libraries
@@ -95,6 +100,12 @@ let package = Package(
       publicHeadersPath: "include",
       swiftSettings: swiftSettings
     ),
+    // Only linked into the tests and benchmarks, it replaces the allocator of the whole process.
+    .target(
+      name: "CAllocationCounter",
+      path: "Sources/LinkedLibraries/CAllocationCounter",
+      publicHeadersPath: "include"
+    ),
     // Plugin targets
     .executableTarget(
       name: "ShaderGeneratorTool",
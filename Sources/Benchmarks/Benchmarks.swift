@@ -0,0 +1,247 @@
+import CAllocationCounter
+import Fixtures
+import Foundation
+@_spi(Benchmarks) import ShapeTree
+@_spi(Benchmarks) import Wayland
+
+/// Run with `swift run -c release Benchmarks [--output results.json] [--baseline old.json]`.
+///
+/// Prints a summary to standard error and the results as JSON to standard
+/// output, or to `--output`. Pass the JSON of an earlier commit as `--baseline`
+/// to see how much every benchmark changed. `--filter` only runs benchmarks
+/// whose name contains it and `--iterations` sets the number of timed runs.
+@main
+@MainActor
+struct Benchmarks {
+  struct Options {
+    var output: String? = nil
+    var baseline: String? = nil
+    var filter: String? = nil
+    var iterations = 25
+  }
+
+  struct Report: Codable {
+    let iterations: Int
+    /// Peak resident memory of the whole run.
+    let maxResidentBytes: UInt
+    let results: [Entry]
+  }
+
+  struct Entry: Codable {
+    let name: String
+    let nodes: Int
+    /// Median of the timed runs.
+    let nanoseconds: Double
+    let nanosecondsPerNode: Double
+    /// Heap allocations of a single run.
+    let allocationsPerFrame: UInt
+    /// Most heap memory a single run held at once on top of what it started with.
+    let peakBytes: UInt
+  }
+
+  static var options = Options()
+  static var results: [Entry] = []
+
+  static func main() throws {
+    options = try parse(Array(CommandLine.arguments.dropFirst()))
+
+    // Traversal cost: four walks with one walker each versus one walk
+    // driving the same four walkers.
+    let list = GeneratedList(rows: 10_000)
+    let listNodes = countNodes(list)
+    benchmark("traversal/4 separate walks", nodes: listNodes) {
+      for _ in 0..<4 {
+        var walker = CountingWalker()
+        list.walk(with: &walker)
+      }
+    }
+    benchmark("traversal/4 walkers, 1 walk", nodes: listNodes) {
+      var walkers = Walkers(CountingWalker(), CountingWalker(), CountingWalker(), CountingWalker())
+      list.walk(with: &walkers)
+    }
+
+    // Glyph generation, one instance per byte of a single long text.
+    let ascii = String(decoding: (0..<1 << 20).map { UInt8(32 + $0 % 95) }, as: UTF8.self)
+    benchmark("text/1 MB ASCII", nodes: ascii.utf8.count) {
+      _ = Wayland.layOutText(ascii)
+    }
+
+    suite("wide", list)
+    suite("deep", GeneratedNesting(depth: 500))
+    suite("grow", GeneratedGrowRows(rows: 200, columns: 25))
+    // Every block kind, compare against an earlier commit to see the cost of dispatching on them.
+    suite("grid", GeneratedGrid(rows: 100, columns: 50))
+
+    // Whole frames through the GL renderer, where EGL can render without a display.
+    do {
+      try Wayland.setupHeadless(width: 800, height: 600)
+      Wayland.skipsUnchangedFrames = false
+      frames("screen", Screen(scale: 2, ips: ["1.1.1.1", "10.0.0.2"], fps: "60 FPS"))
+      frames("borders", Borders(scale: 2))
+      frames("toolbar", SystemToolbar(battery: "69%", batteryColor: .pink, time: "12:00"))
+    } catch {
+      log("skipping GPU frames: \(error)")
+    }
+
+    try finish()
+  }
+
+  /// Times drawing `block` into the headless framebuffer until the GPU is done with it.
+  static func frames(_ name: String, _ block: some Block) {
+    benchmark("gpu/\(name) frame", nodes: countNodes(block)) {
+      Wayland.preDraw()
+      Wayland.render(block)
+      Wayland.postDraw()
+    }
+  }
+
+  /// Times every walker on its own, the whole layout with and without a cache,
+  /// and rendering the layout into the frame recorder.
+  static func suite(_ tree: String, _ block: some Block) {
+    let settings = Wayland.fontSettings
+    let phases = LayoutPhases(block, height: 600, width: 800, settings: settings)
+    let nodes = phases.nodeCount
+
+    benchmark("\(tree)/walk", nodes: nodes) {
+      var walker = CountingWalker()
+      block.walk(with: &walker)
+    }
+    benchmark("\(tree)/AttributesWalker", nodes: nodes) { _ = phases.walkAttributes() }
+    benchmark("\(tree)/SizeWalker", nodes: nodes) { _ = phases.walkSizes() }
+    benchmark("\(tree)/GrowWalker", nodes: nodes) { _ = phases.walkGrow() }
+    benchmark("\(tree)/PositionWalker", nodes: nodes) { _ = phases.walkPositions() }
+    benchmark("\(tree)/calculateLayout", nodes: nodes) {
+      _ = calculateLayout(block, height: 600, width: 800, settings: settings)
+    }
+    let cache = LayoutCache()
+    benchmark("\(tree)/calculateLayout, unchanged with cache", nodes: nodes) {
+      _ = calculateLayout(block, height: 600, width: 800, settings: settings, cache: cache)
+    }
+    let layout = calculateLayout(block, height: 600, width: 800, settings: settings)
+    benchmark("\(tree)/RenderWalker", nodes: nodes) {
+      _ = Wayland.recordFrame(block, layout: layout, settings: settings)
+    }
+  }
+
+  static func countNodes(_ block: some Block) -> Int {
+    var walker = CountingWalker()
+    block.walk(with: &walker)
+    return walker.visited
+  }
+
+  /// Takes the median of the timed runs after one warm up run, then counts
+  /// the allocations of one more run so the timings do not include counting.
+  static func benchmark(_ name: String, nodes: Int, _ body: () -> Void) {
+    if let filter = options.filter, !name.contains(filter) {
+      return
+    }
+    body()
+    let clock = ContinuousClock()
+    var samples: [Duration] = []
+    samples.reserveCapacity(options.iterations)
+    for _ in 0..<options.iterations {
+      samples.append(clock.measure(body))
+    }
+    let median = samples.sorted()[options.iterations / 2]
+
+    allocation_counter_start()
+    body()
+    let allocations = UInt(allocation_counter_stop())
+    let peakBytes = UInt(allocation_counter_peak_bytes())
+
+    let nanoseconds = Double(median.components.seconds) * 1e9 + Double(median.components.attoseconds) / 1e9
+    let result = Entry(
+      name: name, nodes: nodes, nanoseconds: nanoseconds, nanosecondsPerNode: nanoseconds / Double(nodes),
+      allocationsPerFrame: allocations, peakBytes: peakBytes)
+    results.append(result)
+    log(
+      "\(name): \(median) (\(rounded(result.nanosecondsPerNode)) ns/node, \(allocations) allocations, "
+        + "\(peakBytes / 1024) KiB peak)")
+  }
+
+  static func finish() throws {
+    let report = Report(iterations: options.iterations, maxResidentBytes: maxResidentBytes(), results: results)
+    let encoder = JSONEncoder()
+    encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+    let json = try encoder.encode(report)
+    if let output = options.output {
+      try json.write(to: URL(fileURLWithPath: output))
+    } else {
+      FileHandle.standardOutput.write(json)
+      FileHandle.standardOutput.write(Data("\n".utf8))
+    }
+
+    guard let baseline = options.baseline else { return }
+    let old = try JSONDecoder().decode(Report.self, from: Data(contentsOf: URL(fileURLWithPath: baseline)))
+    let before = Dictionary(old.results.map { ($0.name, $0) }, uniquingKeysWith: { first, _ in first })
+    log("\ncompared to \(baseline):")
+    for result in results {
+      guard let previous = before[result.name], previous.nanosecondsPerNode > 0 else { continue }
+      let change = (result.nanosecondsPerNode / previous.nanosecondsPerNode - 1) * 100
+      let allocations = Int(result.allocationsPerFrame) - Int(previous.allocationsPerFrame)
+      log("\(result.name): \(change >= 0 ? "+" : "")\(rounded(change))% time, \(allocations) allocations")
+    }
+  }
+
+  static func parse(_ arguments: [String]) throws -> Options {
+    var options = Options()
+    var remaining = arguments[...]
+    while let argument = remaining.popFirst() {
+      guard let value = remaining.popFirst() else {
+        throw BenchmarkError.missingValue(argument)
+      }
+      switch argument {
+      case "--output": options.output = value
+      case "--baseline": options.baseline = value
+      case "--filter": options.filter = value
+      case "--iterations":
+        guard let iterations = Int(value), iterations > 0 else {
+          throw BenchmarkError.invalidValue(argument, value)
+        }
+        options.iterations = iterations
+      default: throw BenchmarkError.unknownArgument(argument)
+      }
+    }
+    return options
+  }
+
+  /// High water mark of the resident set from `/proc`, `0` where it is not available.
+  static func maxResidentBytes() -> UInt {
+    guard let status = try? String(contentsOfFile: "/proc/self/status", encoding: .utf8) else { return 0 }
+    for line in status.split(separator: "\n") where line.hasPrefix("VmHWM:") {
+      let kilobytes = line.split(whereSeparator: \.isWhitespace).dropFirst().first.flatMap { UInt($0) }
+      return (kilobytes ?? 0) * 1024
+    }
+    return 0
+  }
+
+  static func rounded(_ value: Double) -> Double {
+    (value * 10).rounded() / 10
+  }
+
+  static func log(_ message: String) {
+    FileHandle.standardError.write(Data((message + "\n").utf8))
+  }
+}
+
+enum BenchmarkError: Error {
+  case missingValue(String)
+  case invalidValue(String, String)
+  case unknownArgument(String)
+}
+
+struct CountingWalker: Walker {
+  var currentId: Hash = 0
+  var parentId: Hash = 0
+  var currentIndex: NodeIndex = NodeTable.none
+  var parentIndex: NodeIndex = NodeTable.none
+  var nextIndex: NodeIndex = 0
+  var visited = 0
+
+  mutating func before(_ block: some Block) {
+    visited += 1
+  }
+  mutating func after(_ block: some Block) {}
+  mutating func before(child block: some Block) {}
+  mutating func after(child block: some Block) {}
+}
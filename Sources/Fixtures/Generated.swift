@@ -0,0 +1,98 @@
+import ShapeTree
+
+/// A flat vertical list of `rows` text blocks, used to stress the walkers.
+public struct GeneratedList: Block {
+  let rows: Int
+
+  public init(rows: Int) {
+    self.rows = rows
+  }
+
+  public var layer: some Block {
+    Direction(.vertical) {
+      for row in 0..<rows {
+        Text("Row \(row)")
+      }
+    }
+  }
+}
+
+/// A `rows` by `columns` grid mixing every kind of block: directions, groups,
+/// attributed text and rectangles.
+public struct GeneratedGrid: Block {
+  let rows: Int
+  let columns: Int
+
+  public init(rows: Int, columns: Int) {
+    self.rows = rows
+    self.columns = columns
+  }
+
+  public var layer: some Block {
+    Direction(.vertical) {
+      for row in 0..<rows {
+        Direction(.horizontal) {
+          for column in 0..<columns {
+            Text("\(row):\(column)")
+              .scale(2)
+              .foreground(.cyan)
+              .padding(2)
+            Rect()
+              .width(.fixed(4))
+              .height(.fixed(4))
+              .background(.orange)
+          }
+        }
+      }
+    }
+  }
+}
+
+/// Directions nested `depth` levels deep, alternating orientation, with a text at every level.
+public struct GeneratedNesting: Block {
+  let depth: Int
+
+  public init(depth: Int) {
+    self.depth = depth
+  }
+
+  public var layer: some Block {
+    Direction(depth.isMultiple(of: 2) ? .vertical : .horizontal) {
+      Text("Level \(depth)")
+      if depth > 0 {
+        GeneratedNesting(depth: depth - 1)
+      }
+    }
+  }
+}
+
+/// `rows` horizontal rows like ``MixedGrowDemo``, each alternating `columns`
+/// fixed rectangles with rectangles that grow to share the rest of the row.
+public struct GeneratedGrowRows: Block {
+  let rows: Int
+  let columns: Int
+
+  public init(rows: Int, columns: Int) {
+    self.rows = rows
+    self.columns = columns
+  }
+
+  public var layer: some Block {
+    Direction(.vertical) {
+      for _ in 0..<rows {
+        Direction(.horizontal) {
+          for _ in 0..<columns {
+            Rect()
+              .width(.fixed(20))
+              .height(.fixed(10))
+              .background(.red)
+            Rect()
+              .width(.grow)
+              .height(.grow)
+              .background(.blue)
+          }
+        }
+      }
+    }
+  }
+}
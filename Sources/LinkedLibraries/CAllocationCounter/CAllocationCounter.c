@@ -0,0 +1,95 @@
+// Counts heap allocations for tests and benchmarks by interposing the
+// allocator. Linked into an executable these definitions take precedence over
+// the C library's and forward to glibc's internal entry points.
+#include "CAllocationCounter.h"
+
+// __GLIBC__ is only defined once a C library header is included, the check
+// below has to come after one or counting is silently disabled.
+#include <stdlib.h>
+
+#if defined(__linux__) && defined(__GLIBC__)
+
+#include <errno.h>
+#include <malloc.h>
+#include <stddef.h>
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *pointer);
+
+static _Thread_local int counting = 0;
+static _Thread_local unsigned long allocations = 0;
+// Bytes allocated minus bytes freed since counting started. Freeing memory
+// allocated before that can take it below zero.
+static _Thread_local long live = 0;
+static _Thread_local long peak = 0;
+
+int allocation_counter_is_supported(void) { return 1; }
+
+void allocation_counter_start(void) {
+  allocations = 0;
+  live = 0;
+  peak = 0;
+  counting = 1;
+}
+
+unsigned long allocation_counter_stop(void) {
+  counting = 0;
+  return allocations;
+}
+
+unsigned long allocation_counter_peak_bytes(void) { return (unsigned long)peak; }
+
+static void *allocated(void *pointer) {
+  if (counting && pointer != NULL) {
+    allocations++;
+    live += (long)malloc_usable_size(pointer);
+    if (live > peak) peak = live;
+  }
+  return pointer;
+}
+
+static void freeing(void *pointer) {
+  if (counting && pointer != NULL) live -= (long)malloc_usable_size(pointer);
+}
+
+void *malloc(size_t size) { return allocated(__libc_malloc(size)); }
+
+void *calloc(size_t count, size_t size) { return allocated(__libc_calloc(count, size)); }
+
+void *realloc(void *pointer, size_t size) {
+  size_t old = counting && pointer != NULL ? malloc_usable_size(pointer) : 0;
+  void *result = __libc_realloc(pointer, size);
+  // A failed resize leaves the old block allocated.
+  if (result == NULL && size != 0) return NULL;
+  if (counting) live -= (long)old;
+  return allocated(result);
+}
+
+void *memalign(size_t alignment, size_t size) { return allocated(__libc_memalign(alignment, size)); }
+
+void *aligned_alloc(size_t alignment, size_t size) { return allocated(__libc_memalign(alignment, size)); }
+
+int posix_memalign(void **result, size_t alignment, size_t size) {
+  if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) return EINVAL;
+  void *pointer = allocated(__libc_memalign(alignment, size));
+  if (pointer == NULL) return ENOMEM;
+  *result = pointer;
+  return 0;
+}
+
+void free(void *pointer) {
+  freeing(pointer);
+  __libc_free(pointer);
+}
+
+#else
+
+int allocation_counter_is_supported(void) { return 0; }
+void allocation_counter_start(void) {}
+unsigned long allocation_counter_stop(void) { return 0; }
+unsigned long allocation_counter_peak_bytes(void) { return 0; }
+
+#endif
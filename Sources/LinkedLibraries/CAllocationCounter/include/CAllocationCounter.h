@@ -0,0 +1,17 @@
+#ifndef C_ALLOCATION_COUNTER_H
+#define C_ALLOCATION_COUNTER_H
+
+/// Non zero when this platform's allocator can be counted.
+int allocation_counter_is_supported(void);
+
+/// Starts counting heap allocations made on the calling thread.
+void allocation_counter_start(void);
+
+/// Stops counting and returns the allocations made since `allocation_counter_start`.
+unsigned long allocation_counter_stop(void);
+
+/// Highest number of bytes the calling thread had allocated and not yet freed
+/// at any point between the last `allocation_counter_start` and `allocation_counter_stop`.
+unsigned long allocation_counter_peak_bytes(void);
+
+#endif
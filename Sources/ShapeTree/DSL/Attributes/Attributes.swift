@@ -1,4 +1,4 @@
-public struct Attributes {
+public struct Attributes: Sendable {
   public var width: Sizing
   public var height: Sizing
   public var foreground: Color?
@@ -9,6 +9,19 @@ public struct AttributedBlock<B: Block>: Block, HasAttributes {
   public var layer: B {
     wrapped
   }
+
+  public var _kind: BlockKind {
+    if case .text(let text) = wrapped._kind {
+      return .attributed(attributes, text: text)
+    }
+    return .attributed(attributes, text: nil)
+  }
+
+  public func _walkLayer(with walker: inout some Walker, _ orientation: Orientation) {
+    // Wrapped text is drawn as part of this block.
+    if case .text = wrapped._kind { return }
+    wrapped.walk(with: &walker)
+  }
 }
 
 extension Block {
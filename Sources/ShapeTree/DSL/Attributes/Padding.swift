@@ -1,4 +1,4 @@
-public struct Padding: Equatable {
+public struct Padding: Equatable, Sendable {
   public var top: UInt?
   public var right: UInt?
   public var bottom: UInt?
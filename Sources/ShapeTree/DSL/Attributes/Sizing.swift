@@ -1,4 +1,4 @@
-public enum Sizing: Equatable {
+public enum Sizing: Equatable, Sendable {
   case fixed(UInt)  // Specify a specify size
   case fit  // Fit to the size needed
   case grow  // Grow to the space allowed
@@ -3,6 +3,30 @@
 public protocol Block {
   associatedtype Component: Block
   @BlockParser var layer: Component { get }
+  /// How the walkers treat this block, defaults to ``BlockKind/composed``.
+  var _kind: BlockKind { get }
+  /// Walks everything below this block, defaults to walking ``layer``.
+  func _walkLayer(with walker: inout some Walker, _ orientation: Orientation)
+}
+
+/// What a block is to the walkers. Each conformance answers this itself so a
+/// walk never has to cast a block to find out.
+public enum BlockKind {
+  /// A user defined block made out of its ``Block/layer``.
+  case composed
+  case text(Text)
+  /// A block with modifiers applied, `text` is set when they wrap a ``Text``.
+  case attributed(Attributes, text: Text?)
+  case direction(Orientation)
+  case group(isEmpty: Bool)
+}
+
+extension Block {
+  public var _kind: BlockKind { .composed }
+
+  public func _walkLayer(with walker: inout some Walker, _ orientation: Orientation) {
+    layer.walk(with: &walker, orientation)
+  }
 }
 
 extension Block where Component == Never {
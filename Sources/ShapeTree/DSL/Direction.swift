@@ -1,5 +1,5 @@
 /// Specifiies the direction in which to layout the child elements.
-public struct Direction<B: Block>: Block, DirectionGroup {
+public struct Direction<B: Block>: Block {
   let orientation: Orientation
   let wrapped: B
 
@@ -11,14 +11,15 @@ public struct Direction<B: Block>: Block, DirectionGroup {
   public var layer: some Block {
     wrapped
   }
+
+  public var _kind: BlockKind { .direction(orientation) }
+
+  public func _walkLayer(with walker: inout some Walker, _ orientation: Orientation) {
+    wrapped.walk(with: &walker, self.orientation)
+  }
 }
 
-public enum Orientation {
+public enum Orientation: Sendable {
   case horizontal
   case vertical
 }
-
-@MainActor
-protocol DirectionGroup {
-  var orientation: Orientation { get }
-}
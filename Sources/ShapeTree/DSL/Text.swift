@@ -5,6 +5,11 @@ public struct Text: Block {
     self.label = text
   }
 
+  public var _kind: BlockKind { .text(self) }
+
+  // Text is a leaf.
+  public func _walkLayer(with walker: inout some Walker, _ orientation: Orientation) {}
+
   public func width(_ scale: UInt, using fontMetrics: some FontMetrics) -> UInt {
     // (size of the characters) * (number of spaces) - (trailing space)
     return (UInt(label.count) * fontMetrics.glyphWidth * scale) + (UInt(label.count) * fontMetrics.glyphSpacing * scale)
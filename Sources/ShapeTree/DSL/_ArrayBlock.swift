@@ -1,17 +1,15 @@
-public struct _ArrayBlock<Element: Block>: Block, BlockGroup {
+public struct _ArrayBlock<Element: Block>: Block {
   let _children: [Element]
 
   init(_ children: [Element]) {
     self._children = children
   }
-}
 
-extension _ArrayBlock {
-  var children: [any Block] {
-    var out: [any Block] = []
-    for child in _children {
-      out.append(child)
+  public var _kind: BlockKind { .group(isEmpty: _children.isEmpty) }
+
+  public func _walkLayer(with walker: inout some Walker, _ orientation: Orientation) {
+    for (index, child) in _children.enumerated() {
+      child.walk(asChildAt: index, with: &walker, orientation)
     }
-    return out
   }
 }
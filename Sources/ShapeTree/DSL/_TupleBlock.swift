@@ -1,22 +1,28 @@
-public struct _TupleBlock<each Component: Block>: Block, BlockGroup {
+public struct _TupleBlock<each Component: Block>: Block {
   let _children: (repeat each Component)
 
   init(_ child: repeat each Component) {
     self._children = (repeat each child)
   }
-}
 
-extension _TupleBlock {
-  var children: [any Block] {
-    var out: [any Block] = []
-    for child in repeat (each _children) {
-      out.append(child)
+  public var _kind: BlockKind { .group(isEmpty: childCount == 0) }
+
+  public func _walkLayer(with walker: inout some Walker, _ orientation: Orientation) {
+    var index = 0
+    for child in repeat each _children {
+      child.walk(asChildAt: index, with: &walker, orientation)
+      index += 1
     }
-    return out
   }
 }
 
-@MainActor
-protocol BlockGroup {
-  var children: [any Block] { get }
+extension _TupleBlock {
+  var childCount: Int {
+    // The length of the pack is part of the type so this is unrolled into a constant.
+    var count = 0
+    for _ in repeat each _children {
+      count += 1
+    }
+    return count
+  }
 }
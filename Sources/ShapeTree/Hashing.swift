@@ -9,3 +9,32 @@ func hash(_ string: String) -> Hash {
 func hash(_ value: UInt64) -> Hash {
   XXH3.hash(value, seed: 42069)
 }
+
+/// Folds `value` into `seed`. Unlike `|` the result depends on the order values
+/// are folded in, which is what fingerprints of ordered children need.
+func mix(_ seed: Hash, _ value: Hash) -> Hash {
+  var h = seed ^ (value &+ 0x9e37_79b9_7f4a_7c15 &+ (seed << 6) &+ (seed >> 2))
+  // Finalizer from MurmurHash3 so nearby inputs spread over all bits.
+  h ^= h >> 33
+  h &*= 0xff51_afd7_ed55_8ccd
+  h ^= h >> 33
+  h &*= 0xc4ce_b9fe_1a85_ec53
+  h ^= h >> 33
+  return h
+}
+
+// Names are hashed rather than using `ObjectIdentifier` bits so IDs stay the
+// same between runs, and cached so every type is only formatted once.
+@MainActor private var typeIds: [ObjectIdentifier: Hash] = [:]
+
+/// Stable identifier of `type`, built from its fully qualified name.
+@MainActor
+func typeId(of type: Any.Type) -> Hash {
+  let key = ObjectIdentifier(type)
+  if let id = typeIds[key] {
+    return id
+  }
+  let id = hash(String(reflecting: type))
+  typeIds[key] = id
+  return id
+}
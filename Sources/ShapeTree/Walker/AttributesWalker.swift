@@ -1,31 +1,54 @@
+import Logging
+
 @MainActor
 struct AttributesWalker: Walker {
   var currentId: Hash = 0
   var parentId: Hash = 0
-  var tree: [Hash: [Hash]] = [:]
-  var attributes: [Hash: Attributes] = [:]
-  private var current: Attributes = Attributes()
+  var currentIndex: NodeIndex = NodeTable.none
+  var parentIndex: NodeIndex = NodeTable.none
+  var nextIndex: NodeIndex = 0
+  var nodes = NodeTable()
+  /// Pairs of nodes that were given the same ID, only filled when checking for collisions.
+  private(set) var collisions: [(first: NodeIndex, second: NodeIndex)] = []
+  // Index of every ID seen so far, `nil` when collisions are not checked.
+  private var seen: [Hash: NodeIndex]?
+  private let logger: Logger
 
-  private mutating func connect(parent: Hash, current: Hash) {
-    if var sibilings = tree[parent] {
-      sibilings.append(current)
-      tree[parent] = sibilings
-    } else {
-      tree[parent] = [current]
-    }
+  #if DEBUG
+    static let checksCollisions = true
+  #else
+    static let checksCollisions = false
+  #endif
+
+  /// Checking every ID against the ones before it costs a dictionary so it is
+  /// only on by default in debug builds.
+  init(checksCollisions: Bool = Self.checksCollisions, logLevel: Logger.Level = .warning) {
+    self.seen = checksCollisions ? [:] : nil
+    self.logger = Logger.create(logLevel: logLevel)
   }
 
   mutating func before(_ block: some Block) {
-    connect(parent: parentId, current: currentId)
-    if let attributedBlock = block as? any HasAttributes {
-      attributes[currentId] = attributedBlock.attributes
+    var attributes: Attributes? = nil
+    if case .attributed(let blockAttributes, _) = block._kind {
+      attributes = blockAttributes
+    }
+    let index = nodes.append(id: currentId, parent: parentIndex, attributes: attributes)
+    assert(index == currentIndex, "Node table out of sync with walk order")
+    if seen != nil {
+      check(currentId, at: index)
     }
   }
 
-  mutating func after(_ block: some Block) {
-    current = attributes[currentId] ?? Attributes()
+  private mutating func check(_ id: Hash, at index: NodeIndex) {
+    guard let first = seen?.updateValue(index, forKey: id) else { return }
+    collisions.append((first, index))
+    logger.warning("ID collision: node \(index) has the same ID \(id) as node \(first)")
   }
 
+  mutating func after(_ block: some Block) {
+    // Every descendant has been appended by now.
+    nodes.close(currentIndex, end: nextIndex)
+  }
   mutating func before(child block: some Block) {}
   mutating func after(child block: some Block) {}
 }
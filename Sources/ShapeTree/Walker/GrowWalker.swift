@@ -2,69 +2,142 @@
 struct GrowWalker: Walker {
   var currentId: Hash = 0
   var parentId: Hash = 0
-  var sizes: [Hash: Container]
-  let attributes: [Hash: Attributes]
-  let tree: [Hash: [Hash]]
-
-  init(sizes: [Hash: Container], attributes: [Hash: Attributes], tree: [Hash: [Hash]]) {
-    self.sizes = sizes
-    self.attributes = attributes
-    self.tree = tree
+  var currentIndex: NodeIndex = NodeTable.none
+  var parentIndex: NodeIndex = NodeTable.none
+  var nextIndex: NodeIndex = 0
+  let nodes: NodeTable
+  /// Final sizes, shared so a ``PositionWalker`` in the same traversal sees them.
+  let storage: SharedColumn<Container>
+  // Sizes after a container is stretched to fit its grow descendants but before
+  // its parent hands out its share. A container distributes using these.
+  let expanded: SharedColumn<Container>
+  let cache: LayoutCache?
+  private var reusable: NodeIndex? = nil
+  private let rules: GrowRules
+
+  var sizes: NodeColumn<Container> { storage.column }
+
+  /// With a `cache` subtrees that were grown in the same container last time are
+  /// copied from the previous layout. Its fingerprints must belong to `nodes`.
+  init(sizes: NodeColumn<Container>, nodes: NodeTable, cache: LayoutCache? = nil) {
+    self.storage = SharedColumn(sizes)
+    self.expanded = SharedColumn(sizes)
+    self.nodes = nodes
+    self.cache = cache
+    self.rules = GrowRules(nodes: nodes)
   }
 
-  // Check whether any descendant of `nodeId` has a .grow width or height.
-  private func hasGrowDescendant(_ nodeId: Hash, width: Bool, height: Bool) -> Bool {
-    guard let children = tree[nodeId] else { return false }
-    for childId in children {
-      if width, attributes[childId]?.width == .grow { return true }
-      if height, attributes[childId]?.height == .grow { return true }
-      if hasGrowDescendant(childId, width: width, height: height) { return true }
+  // Children are settled when their container is entered, so a walker running
+  // after this one in the same traversal already sees their final sizes.
+  mutating func before(_ block: some Block) {
+    guard nodes.hasChildren(currentIndex) else { return }
+    if let cache {
+      cache.recordGrown(
+        key(currentIndex), start: currentIndex, descendants: nodes.descendantCount(of: currentIndex))
     }
-    return false
+    rules.settle(currentIndex, expanded: &expanded.column, sizes: &storage.column)
   }
 
-  mutating func before(_ block: some Block) {
-    guard let children = tree[currentId], !children.isEmpty else { return }
-    guard var container = sizes[currentId] else { return }
-    guard let parent = sizes[parentId] else { return }
+  func key(_ index: NodeIndex) -> LayoutCache.SubtreeKey {
+    LayoutCache.SubtreeKey(fingerprint: cache?.fingerprints[index] ?? 0, container: expanded.column[index])
+  }
 
-    let needW = hasGrowDescendant(currentId, width: true, height: false)
-    let needH = hasGrowDescendant(currentId, width: false, height: true)
+  func knownId(at index: NodeIndex) -> Hash? {
+    nodes.id(at: index)
+  }
+
+  mutating func descendantsToSkip() -> NodeIndex {
+    reusable = nil
+    guard let cache, nodes.hasChildren(currentIndex) else { return 0 }
+    let descendants = nodes.descendantCount(of: currentIndex)
+    reusable = cache.grown(key(currentIndex), descendants: descendants)
+    return reusable == nil ? 0 : descendants
+  }
 
-    if needW && container.width < parent.width {
+  mutating func skipDescendants() {
+    guard let cache, let start = reusable else { return }
+    let descendants = nodes.descendantCount(of: currentIndex)
+    storage.column.replace(from: currentIndex + 1, with: cache.sizes, start + 1..<start + 1 + descendants)
+    cache.reused(descendants)
+  }
+
+  mutating func after(_ block: some Block) {}
+  mutating func before(child block: some Block) {}
+  mutating func after(child block: some Block) {}
+}
+
+/// How a container hands its size out to its children. Shared by the
+/// ``GrowWalker`` and ``LayoutSnapshot`` so both grow exactly the same way.
+struct GrowRules: Sendable {
+  let nodes: NodeTable
+  // Whether any descendant of a node has a .grow width or height.
+  private let growWidthBelow: NodeColumn<Bool>
+  private let growHeightBelow: NodeColumn<Bool>
+
+  init(nodes: NodeTable) {
+    self.nodes = nodes
+    // Descendants always have larger pre-order indices so a single reverse
+    // sweep folds every subtree into its parent.
+    var growWidthBelow = NodeColumn(repeating: false, count: nodes.count)
+    var growHeightBelow = NodeColumn(repeating: false, count: nodes.count)
+    for index in nodes.ids.indices.reversed() {
+      let parent = nodes.parent[index]
+      guard parent != NodeTable.none else { continue }
+      let attrs = nodes.attributes(at: index)
+      if attrs?.width == .grow || growWidthBelow[index] {
+        growWidthBelow[parent] = true
+      }
+      if attrs?.height == .grow || growHeightBelow[index] {
+        growHeightBelow[parent] = true
+      }
+    }
+    self.growWidthBelow = growWidthBelow
+    self.growHeightBelow = growHeightBelow
+  }
+
+  /// The rules for the nodes in `range` of `other`, renumbered from `0`.
+  init(_ other: GrowRules, slice range: Range<NodeIndex>) {
+    self.nodes = other.nodes.slice(range)
+    self.growWidthBelow = other.growWidthBelow.slice(range)
+    self.growHeightBelow = other.growHeightBelow.slice(range)
+  }
+
+  // Stretch a container with grow descendants to its parent's extent.
+  private func expand(_ index: NodeIndex, within parent: Container, _ expanded: NodeColumn<Container>) -> Container {
+    var container = expanded[index]
+    guard nodes.hasChildren(index) else { return container }
+    if growWidthBelow[index] && container.width < parent.width {
       container.width = parent.width
     }
-    if needH && container.height < parent.height {
+    if growHeightBelow[index] && container.height < parent.height {
       container.height = parent.height
     }
-
-    if (needW && container.width == parent.width) || (needH && container.height == parent.height) {
-      sizes[currentId] = container
-    }
+    return container
   }
 
-  mutating func after(_ block: some Block) {
-    guard let children = tree[currentId], !children.isEmpty else { return }
-    guard let container = sizes[currentId] else { return }
+  /// Stretches and sizes the children of `index` from its own expanded size.
+  func settle(_ index: NodeIndex, expanded: inout NodeColumn<Container>, sizes: inout NodeColumn<Container>) {
+    let container = expanded[index]
 
-    // Collect grow children and compute fixed-space consumption.
-    var hGrowers: [Hash] = []  // .grow width
-    var vGrowers: [Hash] = []  // .grow height
+    // Count grow children and compute fixed-space consumption.
+    var hGrowers = 0  // .grow width
+    var vGrowers = 0  // .grow height
     var fixedWidth: UInt = 0
     var fixedHeight: UInt = 0
 
-    for childId in children {
-      guard let childSize = sizes[childId] else { continue }
-      let attrs = attributes[childId]
+    for child in nodes.children(of: index) {
+      let childSize = expand(child, within: container, expanded)
+      expanded[child] = childSize
+      let attrs = nodes.attributes(at: child)
 
       if attrs?.width == .grow {
-        hGrowers.append(childId)
+        hGrowers += 1
       } else {
         fixedWidth += childSize.width
       }
 
       if attrs?.height == .grow {
-        vGrowers.append(childId)
+        vGrowers += 1
       } else {
         fixedHeight += childSize.height
       }
@@ -73,47 +146,27 @@ struct GrowWalker: Walker {
     // Primary-axis distribution: .grow children share remaining space along
     // the container's orientation axis. Cross-axis: .grow children fill the
     // full container extent (like flexbox align-items: stretch).
-    if container.orientation == .horizontal {
-      // Primary: distribute remaining width to .grow width children.
-      if !hGrowers.isEmpty {
-        let remaining = container.width > fixedWidth ? container.width - fixedWidth : 0
-        let share = remaining / UInt(hGrowers.count)
-        for childId in hGrowers {
-          if var childSize = sizes[childId] {
-            childSize.width = share
-            sizes[childId] = childSize
-          }
-        }
-      }
-      // Cross-axis: .grow height children fill container height.
-      for childId in children {
-        if var childSize = sizes[childId], attributes[childId]?.height == .grow {
-          childSize.height = container.height
-          sizes[childId] = childSize
-        }
-      }
+    let horizontal = container.orientation == .horizontal
+    let remaining: UInt
+    let share: UInt
+    if horizontal {
+      remaining = container.width > fixedWidth ? container.width - fixedWidth : 0
+      share = hGrowers > 0 ? remaining / UInt(hGrowers) : 0
     } else {
-      // Primary: distribute remaining height to .grow height children.
-      if !vGrowers.isEmpty {
-        let remaining = container.height > fixedHeight ? container.height - fixedHeight : 0
-        let share = remaining / UInt(vGrowers.count)
-        for childId in vGrowers {
-          if var childSize = sizes[childId] {
-            childSize.height = share
-            sizes[childId] = childSize
-          }
-        }
+      remaining = container.height > fixedHeight ? container.height - fixedHeight : 0
+      share = vGrowers > 0 ? remaining / UInt(vGrowers) : 0
+    }
+
+    for child in nodes.children(of: index) {
+      var childSize = expanded[child]
+      let attrs = nodes.attributes(at: child)
+      if attrs?.width == .grow {
+        childSize.width = horizontal ? share : container.width
       }
-      // Cross-axis: .grow width children fill container width.
-      for childId in children {
-        if var childSize = sizes[childId], attributes[childId]?.width == .grow {
-          childSize.width = container.width
-          sizes[childId] = childSize
-        }
+      if attrs?.height == .grow {
+        childSize.height = horizontal ? container.height : share
       }
+      sizes[child] = childSize
     }
   }
-
-  mutating func before(child block: some Block) {}
-  mutating func after(child block: some Block) {}
 }
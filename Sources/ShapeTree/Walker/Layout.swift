@@ -1,18 +1,23 @@
-public struct Layout {
-  public let positions: [Hash: (x: UInt, y: UInt)]
-  public let sizes: [Hash: Container]
-  public let attributes: [Hash: Attributes]
-  public let tree: [Hash: [Hash]]
+public typealias Position = (x: UInt, y: UInt)
+
+/// Result of ``calculateLayout(_:height:width:settings:cache:timed:)``. All columns are
+/// indexed by the node's pre-order ``NodeIndex`` in ``nodes``.
+public struct Layout: Sendable {
+  public let nodes: NodeTable
+  public let positions: NodeColumn<Position>
+  public let sizes: NodeColumn<Container>
 
   public init(
-    positions: [Hash: (x: UInt, y: UInt)],
-    sizes: [Hash: Container],
-    attributes: [Hash: Attributes],
-    tree: [Hash: [Hash]]
+    nodes: NodeTable,
+    positions: NodeColumn<Position>,
+    sizes: NodeColumn<Container>
   ) {
+    self.nodes = nodes
     self.positions = positions
     self.sizes = sizes
-    self.attributes = attributes
-    self.tree = tree
+  }
+
+  public func attributes(at index: NodeIndex) -> Attributes? {
+    nodes.attributes(at: index)
   }
 }
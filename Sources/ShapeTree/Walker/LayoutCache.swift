@@ -0,0 +1,102 @@
+/// Remembers the previous ``calculateLayout(_:height:width:settings:cache:timed:)`` so
+/// subtrees that did not change are copied instead of grown and positioned again.
+///
+/// A subtree is reused when its fingerprint from the ``SizeWalker`` and the
+/// container it is grown into match a subtree of the previous layout. Positions
+/// additionally need the same starting point. Only subtrees that were visited
+/// last time are remembered, the descendants of a reused subtree are not.
+@MainActor
+public final class LayoutCache {
+  struct SubtreeKey: Hashable {
+    let fingerprint: Hash
+    let container: Container
+  }
+
+  struct PositionKey: Hashable {
+    let subtree: SubtreeKey
+    let x: UInt
+    let y: UInt
+    let context: LayoutContext?
+  }
+
+  /// Where the ``PositionWalker`` stood after a subtree's descendants were placed.
+  struct PositionExit {
+    let x: UInt
+    let y: UInt
+    let context: LayoutContext?
+  }
+
+  struct Entry<Value> {
+    let start: NodeIndex
+    let descendants: NodeIndex
+    let value: Value
+  }
+
+  /// Fingerprints of the layout being calculated.
+  private(set) var fingerprints = NodeColumn<Hash>()
+  private(set) var sizes = NodeColumn<Container>()
+  private(set) var positions = NodeColumn<Position>()
+  private var grown: [SubtreeKey: Entry<Void>] = [:]
+  private var placed: [PositionKey: Entry<PositionExit>] = [:]
+  private var nextGrown: [SubtreeKey: Entry<Void>] = [:]
+  private var nextPlaced: [PositionKey: Entry<PositionExit>] = [:]
+  private var metrics: [UInt] = []
+
+  /// Number of nodes copied from the previous layout by the last calculation.
+  public private(set) var reusedNodes = 0
+
+  public init() {}
+
+  /// Forgets the previous layout.
+  public func removeAll() {
+    sizes = NodeColumn()
+    positions = NodeColumn()
+    grown.removeAll()
+    placed.removeAll()
+  }
+
+  func prepare(fingerprints: NodeColumn<Hash>, settings: some FontMetrics) {
+    let metrics = [settings.glyphWidth, settings.glyphHeight, settings.glyphSpacing, settings.scale]
+    if metrics != self.metrics {
+      removeAll()
+      self.metrics = metrics
+    }
+    self.fingerprints = fingerprints
+    reusedNodes = 0
+  }
+
+  func commit(sizes: NodeColumn<Container>, positions: NodeColumn<Position>) {
+    self.sizes = sizes
+    self.positions = positions
+    swap(&grown, &nextGrown)
+    swap(&placed, &nextPlaced)
+    nextGrown.removeAll(keepingCapacity: true)
+    nextPlaced.removeAll(keepingCapacity: true)
+  }
+
+  // MARK: - GrowWalker
+
+  func grown(_ key: SubtreeKey, descendants: NodeIndex) -> NodeIndex? {
+    guard let entry = grown[key], entry.descendants == descendants else { return nil }
+    return entry.start
+  }
+
+  func recordGrown(_ key: SubtreeKey, start: NodeIndex, descendants: NodeIndex) {
+    nextGrown[key] = Entry(start: start, descendants: descendants, value: ())
+  }
+
+  func reused(_ descendants: NodeIndex) {
+    reusedNodes += Int(descendants)
+  }
+
+  // MARK: - PositionWalker
+
+  func placed(_ key: PositionKey, descendants: NodeIndex) -> (start: NodeIndex, exit: PositionExit)? {
+    guard let entry = placed[key], entry.descendants == descendants else { return nil }
+    return (entry.start, entry.value)
+  }
+
+  func recordPlaced(_ key: PositionKey, start: NodeIndex, descendants: NodeIndex, exit: PositionExit) {
+    nextPlaced[key] = Entry(start: start, descendants: descendants, value: exit)
+  }
+}
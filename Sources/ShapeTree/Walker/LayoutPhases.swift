@@ -0,0 +1,55 @@
+/// Runs each walker of ``calculateLayout(_:height:width:settings:cache:timed:)`` on
+/// its own so the phases can be timed separately.
+///
+/// The inputs every phase needs are computed once up front, each `walk` method
+/// then repeats only its own traversal and returns the number of nodes it produced.
+@_spi(Benchmarks)
+@MainActor
+public struct LayoutPhases<B: Block, Metrics: FontMetrics> {
+  let block: B
+  let settings: Metrics
+  let nodes: NodeTable
+  let measured: NodeColumn<Container>
+  let grown: NodeColumn<Container>
+
+  public init(_ block: B, height: UInt, width: UInt, settings: Metrics) {
+    self.block = block
+    self.settings = settings
+    var attributesWalker = AttributesWalker(checksCollisions: false)
+    block.walk(with: &attributesWalker)
+    var sizer = SizeWalker(settings: settings)
+    block.walk(with: &sizer)
+    let orientation = sizer.sizes[attributesWalker.nodes.root].orientation
+    self.nodes = attributesWalker.nodes
+    self.measured = sizer.sizes.convert(root: Container(height: height, width: width, orientation: orientation))
+    var grower = GrowWalker(sizes: measured, nodes: nodes)
+    block.walk(with: &grower)
+    self.grown = grower.sizes
+  }
+
+  public var nodeCount: Int { nodes.count }
+
+  public func walkAttributes() -> Int {
+    var walker = AttributesWalker(checksCollisions: false)
+    block.walk(with: &walker)
+    return walker.nodes.count
+  }
+
+  public func walkSizes() -> Int {
+    var walker = SizeWalker(settings: settings)
+    block.walk(with: &walker)
+    return walker.sizes.count
+  }
+
+  public func walkGrow() -> Int {
+    var walker = GrowWalker(sizes: measured, nodes: nodes)
+    block.walk(with: &walker)
+    return walker.sizes.count
+  }
+
+  public func walkPositions() -> Int {
+    var walker = PositionWalker(sizes: grown, nodes: nodes)
+    block.walk(with: &walker)
+    return walker.positions.count
+  }
+}
@@ -0,0 +1,305 @@
+/// Everything layout reads from a block tree, copied out of the blocks.
+///
+/// Blocks belong to the main actor but a snapshot does not, so it can be laid
+/// out on other threads while the main actor keeps running. The result of
+/// either layout method is identical to ``calculateLayout(_:height:width:settings:cache:timed:)``.
+public struct LayoutSnapshot: Sendable {
+  let nodes: NodeTable
+  // The size of every node's own content, before its children are added.
+  let intrinsic: NodeColumn<Size>
+  let roles: NodeColumn<NodeRole>
+
+  /// Walks `block` once to record its attributes, structure and text sizes.
+  @MainActor
+  public init(_ block: some Block, settings: some FontMetrics) {
+    var walk = Walkers(AttributesWalker(), SizeWalker(settings: settings, foldsChildren: false), RoleWalker())
+    block.walk(with: &walk)
+    let (attributesWalker, sizer, roleWalker) = (consume walk).walkers
+    guard !attributesWalker.nodes.isEmpty else {
+      fatalError("Layout tree has no root element")
+    }
+    self.nodes = attributesWalker.nodes
+    self.intrinsic = sizer.sizes
+    self.roles = roleWalker.roles
+  }
+
+  /// Number of blocks in the snapshot.
+  public var count: Int { nodes.count }
+
+  /// Lays out the whole tree on the calling thread.
+  public func layout(height: UInt, width: UInt) -> Layout {
+    var sizes = Self.window(Self.measure(nodes, intrinsic), height: height, width: width)
+    var expanded = sizes
+    Self.grow(GrowRules(nodes: nodes), expanded: &expanded, sizes: &sizes)
+    var placer = Placer(nodes: nodes, roles: roles, sizes: sizes, rootsAreChildren: false)
+    nodes.traverse(from: nodes.root, with: &placer)
+    return Layout(nodes: nodes, positions: placer.positions, sizes: sizes)
+  }
+
+  /// Lays out the tree on all cores. Small trees are laid out serially.
+  public func parallelLayout(height: UInt, width: UInt) async -> Layout {
+    await parallelLayout(height: height, width: width, grain: max(1024, count / 64))
+  }
+
+  /// Splits the tree into runs of sibling subtrees of at most `grain` nodes.
+  ///
+  /// Every run is measured, grown and placed by its own task. The containers
+  /// above the runs, the spine, are handled serially between the phases:
+  /// summing up their children after measuring, handing out their size before
+  /// growing, and moving the runs to where they start after placing.
+  func parallelLayout(height: UInt, width: UInt, grain: Int) async -> Layout {
+    guard count > grain else {
+      return layout(height: height, width: width)
+    }
+    let (spine, runs) = partition(grain: grain)
+
+    // Measure: runs are complete subtrees, the spine adds them up bottom up.
+    var measured = intrinsic
+    await withTaskGroup(of: (Int, NodeColumn<Size>).self) { group in
+      for (i, run) in runs.enumerated() {
+        group.addTask {
+          (i, Self.measure(nodes.slice(run.range), intrinsic.slice(run.range)))
+        }
+      }
+      for await (i, sizes) in group {
+        measured.replace(from: runs[i].range.lowerBound, with: sizes, sizes.indices)
+      }
+    }
+    let stitched = (spine + runs.flatMap(\.roots)).sorted()
+    for index in stitched.reversed() {
+      let parent = nodes.parent[index]
+      guard parent != NodeTable.none else { continue }
+      measured[parent] = measured[parent].adding(child: measured[index])
+    }
+
+    // Grow: the spine settles top down, which sizes the root of every run.
+    var sizes = Self.window(measured, height: height, width: width)
+    var expanded = sizes
+    let rules = GrowRules(nodes: nodes)
+    for index in spine where nodes.hasChildren(index) {
+      rules.settle(index, expanded: &expanded, sizes: &sizes)
+    }
+    let settled = (expanded, sizes)
+    await withTaskGroup(of: (Int, NodeColumn<Container>).self) { group in
+      for (i, run) in runs.enumerated() {
+        group.addTask {
+          var expanded = settled.0.slice(run.range)
+          var sizes = settled.1.slice(run.range)
+          Self.grow(GrowRules(rules, slice: run.range), expanded: &expanded, sizes: &sizes)
+          return (i, sizes)
+        }
+      }
+      for await (i, column) in group {
+        sizes.replace(from: runs[i].range.lowerBound, with: column, column.indices)
+      }
+    }
+
+    // Place: a run only ever moves the context of the direction around it, so
+    // it is placed as if that context started at zero and moved afterwards.
+    let grown = sizes
+    var placed = [(positions: NodeColumn<Position>, moved: Position)?](repeating: nil, count: runs.count)
+    await withTaskGroup(of: (Int, NodeColumn<Position>, Position).self) { group in
+      for (i, run) in runs.enumerated() {
+        group.addTask {
+          let table = nodes.slice(run.range)
+          var placer = Placer(
+            nodes: table, roles: roles.slice(run.range), sizes: grown.slice(run.range), rootsAreChildren: true)
+          placer.placement.stack = [LayoutContext(x: 0, y: 0, orientation: run.orientation)]
+          table.traverse(from: table.root, with: &placer)
+          let context = placer.placement.stack[0]
+          return (i, placer.positions, (context.x, context.y))
+        }
+      }
+      for await (i, positions, moved) in group {
+        placed[i] = (positions, moved)
+      }
+    }
+    var placer = Placer(nodes: nodes, roles: roles, sizes: grown, rootsAreChildren: false)
+    for (i, run) in runs.enumerated() {
+      placer.runs[run.range.lowerBound] = (i, placed[i]?.moved ?? (0, 0))
+      for root in run.roots {
+        placer.skipped.insert(root)
+      }
+    }
+    nodes.traverse(from: nodes.root, with: &placer)
+    var positions = placer.positions
+    for (i, run) in runs.enumerated() {
+      guard let local = placed[i]?.positions, let start = placer.starts[i] else { continue }
+      for (offset, position) in zip(local.indices, local) {
+        positions[run.range.lowerBound + offset] = (start.x + position.x, start.y + position.y)
+      }
+    }
+    return Layout(nodes: nodes, positions: positions, sizes: grown)
+  }
+
+  /// Consecutive siblings laid out together by one task.
+  struct Run {
+    var range: Range<NodeIndex>
+    var roots: [NodeIndex]
+    /// Orientation of the innermost direction the siblings are in.
+    let orientation: Orientation
+  }
+
+  /// Picks subtrees of at most `grain` nodes and groups adjacent siblings into
+  /// runs of at most `grain` nodes. Returns the nodes above them in pre-order.
+  ///
+  /// Only children of a group inside a direction can start a run. Such a
+  /// child is placed relative to its direction's context, which is what lets
+  /// its run be placed before anything in front of it.
+  func partition(grain: Int) -> (spine: [NodeIndex], runs: [Run]) {
+    var spine: [NodeIndex] = []
+    var roots: [(index: NodeIndex, orientation: Orientation)] = []
+    var pending: [(index: NodeIndex, direction: Orientation?)] = [(nodes.root, nil)]
+    while let next = pending.popLast() {
+      let (index, direction) = next
+      let parent = nodes.parent[index]
+      if let direction, parent != NodeTable.none, roles[parent] == .group,
+        Int(nodes.subtreeEnd[index] - index) <= grain
+      {
+        roots.append((index, direction))
+        continue
+      }
+      spine.append(index)
+      var inner = direction
+      if case .direction(let orientation) = roles[index] {
+        inner = orientation
+      }
+      for child in nodes.children(of: index) {
+        pending.append((child, inner))
+      }
+    }
+    roots.sort { $0.index < $1.index }
+
+    var runs: [Run] = []
+    for root in roots {
+      let end = nodes.subtreeEnd[root.index]
+      if var run = runs.last, run.range.upperBound == root.index,
+        nodes.parent[run.roots[0]] == nodes.parent[root.index], Int(end - run.range.lowerBound) <= grain
+      {
+        run.range = run.range.lowerBound..<end
+        run.roots.append(root.index)
+        runs[runs.count - 1] = run
+      } else {
+        runs.append(Run(range: root.index..<end, roots: [root.index], orientation: root.orientation))
+      }
+    }
+    return (spine.sorted(), runs)
+  }
+
+  // MARK: - Phases
+
+  // Adds every node to its parent. Descendants come after their ancestors in
+  // pre-order so one reverse sweep completes every node before its parent.
+  static func measure(_ nodes: NodeTable, _ intrinsic: NodeColumn<Size>) -> NodeColumn<Size> {
+    var sizes = intrinsic
+    for index in nodes.ids.indices.reversed() {
+      let parent = nodes.parent[index]
+      guard parent != NodeTable.none else { continue }
+      sizes[parent] = sizes[parent].adding(child: sizes[index])
+    }
+    return sizes
+  }
+
+  static func window(_ measured: NodeColumn<Size>, height: UInt, width: UInt) -> NodeColumn<Container> {
+    measured.convert(root: Container(height: height, width: width, orientation: measured[0].orientation))
+  }
+
+  // Parents come before their children in pre-order, so each container is
+  // settled before its children hand out their share.
+  static func grow(_ rules: GrowRules, expanded: inout NodeColumn<Container>, sizes: inout NodeColumn<Container>) {
+    for index in rules.nodes.ids.indices where rules.nodes.hasChildren(index) {
+      rules.settle(index, expanded: &expanded, sizes: &sizes)
+    }
+  }
+}
+
+/// What a node is as far as layout is concerned.
+enum NodeRole: Equatable, Sendable {
+  case direction(Orientation)
+  case group
+  case other
+}
+
+@MainActor
+private struct RoleWalker: Walker {
+  var currentId: Hash = 0
+  var parentId: Hash = 0
+  var currentIndex: NodeIndex = NodeTable.none
+  var parentIndex: NodeIndex = NodeTable.none
+  var nextIndex: NodeIndex = 0
+  var roles = NodeColumn<NodeRole>()
+
+  mutating func before(_ block: some Block) {
+    switch block._kind {
+    case .direction(let orientation):
+      roles.append(.direction(orientation))
+    case .group:
+      roles.append(.group)
+    case .composed, .text, .attributed:
+      roles.append(.other)
+    }
+  }
+  mutating func after(_ block: some Block) {}
+  mutating func before(child block: some Block) {}
+  mutating func after(child block: some Block) {}
+}
+
+/// Places a table the way the ``PositionWalker`` places the blocks it came from.
+private struct Placer: TableVisitor {
+  let nodes: NodeTable
+  let roles: NodeColumn<NodeRole>
+  let sizes: NodeColumn<Container>
+  // Whether nodes without a parent in `nodes` were children of a group.
+  let rootsAreChildren: Bool
+  var placement = Placement()
+  var positions: NodeColumn<Position>
+  /// Runs placed elsewhere, by their first node, with how far they move their context.
+  var runs: [NodeIndex: (index: Int, moved: Position)] = [:]
+  var skipped: Set<NodeIndex> = []
+  /// Where each run's context started.
+  var starts: [Int: Position] = [:]
+
+  init(nodes: NodeTable, roles: NodeColumn<NodeRole>, sizes: NodeColumn<Container>, rootsAreChildren: Bool) {
+    self.nodes = nodes
+    self.roles = roles
+    self.sizes = sizes
+    self.rootsAreChildren = rootsAreChildren
+    self.positions = NodeColumn(repeating: (0, 0), count: nodes.count)
+  }
+
+  private func isChild(_ index: NodeIndex) -> Bool {
+    let parent = nodes.parent[index]
+    return parent == NodeTable.none ? rootsAreChildren : roles[parent] == .group
+  }
+
+  mutating func enter(_ index: NodeIndex) -> Bool {
+    if skipped.contains(index) {
+      if let run = runs[index], let context = placement.stack.last {
+        starts[run.index] = (context.x, context.y)
+        placement.stack[placement.stack.count - 1] = LayoutContext(
+          x: context.x + run.moved.x, y: context.y + run.moved.y, orientation: context.orientation)
+      }
+      return false
+    }
+    if isChild(index) {
+      placement.enterChild()
+    }
+    var direction: Orientation? = nil
+    if case .direction(let orientation) = roles[index] {
+      direction = orientation
+    }
+    positions[index] = placement.enter(direction: direction)
+    return true
+  }
+
+  mutating func exit(_ index: NodeIndex) {
+    var isDirection = false
+    if case .direction = roles[index] {
+      isDirection = true
+    }
+    placement.exit(isDirection: isDirection, size: sizes[index])
+    if isChild(index) {
+      placement.exitChild(size: sizes[index])
+    }
+  }
+}
@@ -0,0 +1,243 @@
+/// Dense index of a node in a ``NodeTable``. Nodes are numbered in pre-order so
+/// the root is always `0` and every descendant of a node has a larger index.
+public typealias NodeIndex = Int32
+
+/// A column of per-node values addressed by ``NodeIndex`` instead of `Int`.
+public struct NodeColumn<Element>: RandomAccessCollection, MutableCollection {
+  var storage: [Element]
+
+  public init() {
+    self.storage = []
+  }
+
+  public init(repeating value: Element, count: Int) {
+    self.storage = Array(repeating: value, count: count)
+  }
+
+  init(_ storage: [Element]) {
+    self.storage = storage
+  }
+
+  public var startIndex: NodeIndex { 0 }
+  public var endIndex: NodeIndex { NodeIndex(storage.count) }
+
+  public subscript(position: NodeIndex) -> Element {
+    get { storage[Int(position)] }
+    set { storage[Int(position)] = newValue }
+  }
+
+  mutating func append(_ element: Element) {
+    storage.append(element)
+  }
+
+  mutating func reserveCapacity(_ capacity: Int) {
+    storage.reserveCapacity(capacity)
+  }
+
+  /// Overwrites the elements starting at `destination` with `other[source]`.
+  mutating func replace(from destination: NodeIndex, with other: NodeColumn<Element>, _ source: Range<NodeIndex>) {
+    let start = Int(destination)
+    storage.replaceSubrange(
+      start..<start + source.count,
+      with: other.storage[Int(source.lowerBound)..<Int(source.upperBound)])
+  }
+
+  func mapColumn<T>(_ transform: (Element) throws -> T) rethrows -> NodeColumn<T> {
+    NodeColumn<T>(try storage.map(transform))
+  }
+
+  /// A copy of the elements in `range`, renumbered from `0`.
+  func slice(_ range: Range<NodeIndex>) -> NodeColumn<Element> {
+    NodeColumn(Array(storage[Int(range.lowerBound)..<Int(range.upperBound)]))
+  }
+}
+
+extension NodeColumn: Sendable where Element: Sendable {}
+
+/// A ``NodeColumn`` behind a reference so walkers fused into one traversal with
+/// ``Walkers`` can read each other's output while it is being written.
+final class SharedColumn<Element> {
+  var column: NodeColumn<Element>
+
+  init(_ column: NodeColumn<Element>) {
+    self.column = column
+  }
+}
+
+/// Struct-of-arrays storage for the block tree built by the ``AttributesWalker``.
+///
+/// Every column is indexed by the node's pre-order ``NodeIndex``. Structure is
+/// stored as parent, first-child and next-sibling links so the later layout
+/// phases can walk children without any hashing or per-node allocations.
+public struct NodeTable: Sendable {
+  public static let none: NodeIndex = -1
+
+  /// Stable ID of each node as computed by ``Block/walk(with:_:)``.
+  public internal(set) var ids = NodeColumn<Hash>()
+  public internal(set) var parent = NodeColumn<NodeIndex>()
+  public internal(set) var firstChild = NodeColumn<NodeIndex>()
+  public internal(set) var nextSibling = NodeColumn<NodeIndex>()
+  /// One past the last descendant. A subtree is the contiguous range `index..<subtreeEnd[index]`.
+  public internal(set) var subtreeEnd = NodeColumn<NodeIndex>()
+  /// Index into ``attributes`` or ``none`` for blocks without attributes.
+  public internal(set) var attributeIndex = NodeColumn<NodeIndex>()
+  public internal(set) var attributes: [Attributes] = []
+  // Only needed while building to append siblings in O(1).
+  private var lastChild = NodeColumn<NodeIndex>()
+
+  public init() {}
+
+  public var count: Int { ids.storage.count }
+  public var isEmpty: Bool { ids.storage.isEmpty }
+  public var root: NodeIndex { isEmpty ? Self.none : 0 }
+
+  mutating func reserveCapacity(_ capacity: Int) {
+    ids.reserveCapacity(capacity)
+    parent.reserveCapacity(capacity)
+    firstChild.reserveCapacity(capacity)
+    nextSibling.reserveCapacity(capacity)
+    subtreeEnd.reserveCapacity(capacity)
+    attributeIndex.reserveCapacity(capacity)
+    lastChild.reserveCapacity(capacity)
+  }
+
+  @discardableResult
+  mutating func append(id: Hash, parent: NodeIndex, attributes: Attributes?) -> NodeIndex {
+    let index = NodeIndex(count)
+    ids.append(id)
+    self.parent.append(parent)
+    firstChild.append(Self.none)
+    nextSibling.append(Self.none)
+    // Leaves end right after themselves, containers are closed by ``close(_:end:)``.
+    subtreeEnd.append(index + 1)
+    lastChild.append(Self.none)
+    if let attributes {
+      attributeIndex.append(NodeIndex(self.attributes.count))
+      self.attributes.append(attributes)
+    } else {
+      attributeIndex.append(Self.none)
+    }
+    if parent != Self.none {
+      let previous = lastChild[parent]
+      if previous == Self.none {
+        firstChild[parent] = index
+      } else {
+        nextSibling[previous] = index
+      }
+      lastChild[parent] = index
+    }
+    return index
+  }
+
+  mutating func close(_ index: NodeIndex, end: NodeIndex) {
+    subtreeEnd[index] = end
+  }
+
+  public func attributes(at index: NodeIndex) -> Attributes? {
+    let slot = attributeIndex[index]
+    return slot == Self.none ? nil : attributes[Int(slot)]
+  }
+
+  public func hasChildren(_ index: NodeIndex) -> Bool {
+    firstChild[index] != Self.none
+  }
+
+  public func descendantCount(of index: NodeIndex) -> NodeIndex {
+    subtreeEnd[index] - index - 1
+  }
+
+  /// Iterates the children of `index` by following sibling links.
+  public func children(of index: NodeIndex) -> Children {
+    Children(first: firstChild[index], nextSibling: nextSibling)
+  }
+
+  /// The ID of `index`, or `nil` when the table has no such node.
+  public func id(at index: NodeIndex) -> Hash? {
+    index >= 0 && index < ids.endIndex ? ids[index] : nil
+  }
+
+  /// The nodes in `range` as a table of their own, renumbered from `0`. The
+  /// range must hold whole subtrees, links that leave it become ``none``.
+  func slice(_ range: Range<NodeIndex>) -> NodeTable {
+    let offset = range.lowerBound
+    func local(_ index: NodeIndex) -> NodeIndex {
+      range.contains(index) ? index - offset : Self.none
+    }
+    var table = NodeTable()
+    table.ids = ids.slice(range)
+    table.parent = parent.slice(range).mapColumn(local)
+    table.firstChild = firstChild.slice(range).mapColumn(local)
+    table.nextSibling = nextSibling.slice(range).mapColumn(local)
+    table.subtreeEnd = subtreeEnd.slice(range).mapColumn { $0 - offset }
+    // Attribute slots keep pointing into the same shared array.
+    table.attributeIndex = attributeIndex.slice(range)
+    table.attributes = attributes
+    return table
+  }
+
+  /// Visits the tree at `first` and the siblings after it in walk order, using
+  /// the links instead of recursion so deep trees need no stack. Descendants of
+  /// a node are skipped when ``TableVisitor/enter(_:)`` returns `false`.
+  func traverse(from first: NodeIndex, with visitor: inout some TableVisitor) {
+    guard first != Self.none else { return }
+    // Climbing back to the parent of `first` means its last sibling is done.
+    let stop = parent[first]
+    var index = first
+    while index != Self.none {
+      let descends = visitor.enter(index)
+      if descends, firstChild[index] != Self.none {
+        index = firstChild[index]
+        continue
+      }
+      if descends {
+        visitor.exit(index)
+      }
+      while nextSibling[index] == Self.none {
+        index = parent[index]
+        guard index != stop else { return }
+        visitor.exit(index)
+      }
+      index = nextSibling[index]
+    }
+  }
+
+  /// Linear lookup of a node by its stable ID. Layout never needs this, it is
+  /// only for callers that hold on to IDs; use ``makeIdIndex()`` for many lookups.
+  public func index(of id: Hash) -> NodeIndex? {
+    ids.firstIndex(of: id)
+  }
+
+  /// Builds the `Hash → index` side table for callers that need stable IDs.
+  public func makeIdIndex() -> [Hash: NodeIndex] {
+    var index: [Hash: NodeIndex] = [:]
+    index.reserveCapacity(count)
+    for (i, id) in zip(ids.indices, ids) {
+      index[id] = i
+    }
+    return index
+  }
+
+  public struct Children: Sequence, IteratorProtocol {
+    var current: NodeIndex
+    let nextSibling: NodeColumn<NodeIndex>
+
+    init(first: NodeIndex, nextSibling: NodeColumn<NodeIndex>) {
+      self.current = first
+      self.nextSibling = nextSibling
+    }
+
+    public mutating func next() -> NodeIndex? {
+      guard current != NodeTable.none else { return nil }
+      defer { current = nextSibling[current] }
+      return current
+    }
+  }
+}
+
+/// Receives the nodes of a ``NodeTable`` in walk order from ``NodeTable/traverse(from:with:)``.
+protocol TableVisitor {
+  /// Returns whether to visit the descendants of `index`.
+  mutating func enter(_ index: NodeIndex) -> Bool
+  /// Called after the descendants of a node that was entered with `true`.
+  mutating func exit(_ index: NodeIndex)
+}
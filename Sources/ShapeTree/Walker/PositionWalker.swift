@@ -3,82 +3,167 @@ struct PositionWalker: Walker {
 
   var currentId: Hash = 0
   var parentId: Hash = 0
-  var attributes: [Hash: Attributes]
-  private(set) var positions: [Hash: (x: UInt, y: UInt)] = [:]
-  private var sizes: [Hash: Container]
-  private var currentX: UInt = 0
-  private var currentY: UInt = 0
-  private var layoutStack: [LayoutContext] = []
-
-  init(sizes: [Hash: Container], attributes: [Hash: Attributes]) {
-    self.sizes = sizes
-    self.attributes = attributes
+  var currentIndex: NodeIndex = NodeTable.none
+  var parentIndex: NodeIndex = NodeTable.none
+  var nextIndex: NodeIndex = 0
+  let nodes: NodeTable
+  private(set) var positions: NodeColumn<Position>
+  private let storage: SharedColumn<Container>
+  // Set when following a ``GrowWalker`` with a ``LayoutCache``.
+  private let expanded: SharedColumn<Container>?
+  private let cache: LayoutCache?
+  // Cache keys of the containers currently being placed.
+  private var open: [LayoutCache.PositionKey] = []
+  private var reusable: (start: NodeIndex, exit: LayoutCache.PositionExit)? = nil
+  private var placement = Placement()
+
+  private var sizes: NodeColumn<Container> { storage.column }
+
+  init(sizes: NodeColumn<Container>, nodes: NodeTable) {
+    self.init(storage: SharedColumn(sizes), nodes: nodes, expanded: nil, cache: nil)
+  }
+
+  /// Reads sizes as `grower` settles them so both can run in one traversal.
+  init(following grower: GrowWalker) {
+    self.init(storage: grower.storage, nodes: grower.nodes, expanded: grower.expanded, cache: grower.cache)
+  }
+
+  private init(
+    storage: SharedColumn<Container>, nodes: NodeTable, expanded: SharedColumn<Container>?, cache: LayoutCache?
+  ) {
+    self.storage = storage
+    self.nodes = nodes
+    self.expanded = expanded
+    self.cache = cache
+    self.positions = NodeColumn(repeating: (0, 0), count: nodes.count)
   }
 
   mutating func before(_ block: some Block) {
-    // Store the current position for this element
-    positions[currentId] = (currentX, currentY)
-    // For orientation blocks, push a new layout context
-    if let group = block as? DirectionGroup {
-      layoutStack.append(LayoutContext(x: currentX, y: currentY, orientation: group.orientation))
+    var direction: Orientation? = nil
+    if case .direction(let orientation) = block._kind {
+      direction = orientation
+    }
+    let position = placement.enter(direction: direction)
+    positions[currentIndex] = position
+    if let cache, let expanded, nodes.hasChildren(currentIndex) {
+      let subtree = LayoutCache.SubtreeKey(
+        fingerprint: cache.fingerprints[currentIndex], container: expanded.column[currentIndex])
+      open.append(
+        LayoutCache.PositionKey(subtree: subtree, x: position.x, y: position.y, context: placement.stack.last))
+    }
+  }
+
+  func knownId(at index: NodeIndex) -> Hash? {
+    nodes.id(at: index)
+  }
+
+  mutating func descendantsToSkip() -> NodeIndex {
+    reusable = nil
+    guard let cache, let key = open.last, nodes.hasChildren(currentIndex) else { return 0 }
+    let descendants = nodes.descendantCount(of: currentIndex)
+    reusable = cache.placed(key, descendants: descendants)
+    return reusable == nil ? 0 : descendants
+  }
+
+  mutating func skipDescendants() {
+    guard let cache, let reusable else { return }
+    let descendants = nodes.descendantCount(of: currentIndex)
+    let start = reusable.start + 1
+    positions.replace(from: currentIndex + 1, with: cache.positions, start..<start + descendants)
+    placement.x = reusable.exit.x
+    placement.y = reusable.exit.y
+    if let context = reusable.exit.context {
+      placement.stack[placement.stack.count - 1] = context
     }
   }
 
   mutating func after(_ block: some Block) {
+    if let cache, expanded != nil, nodes.hasChildren(currentIndex), let key = open.popLast() {
+      cache.recordPlaced(
+        key, start: currentIndex, descendants: nodes.descendantCount(of: currentIndex),
+        exit: LayoutCache.PositionExit(x: placement.x, y: placement.y, context: placement.stack.last))
+    }
+    var isDirection = false
+    if case .direction = block._kind {
+      isDirection = true
+    }
+    placement.exit(isDirection: isDirection, size: sizes[currentIndex])
+  }
+
+  mutating func before(child block: some Block) {
+    placement.enterChild()
+  }
+
+  mutating func after(child block: some Block) {
+    placement.exitChild(size: sizes[currentIndex])
+  }
+}
+
+struct LayoutContext: Hashable {
+  let x: UInt
+  let y: UInt
+  let orientation: Orientation
+}
+
+/// Where the next block goes while walking the tree in pre-order. Shared by the
+/// ``PositionWalker`` and ``LayoutSnapshot`` so both place blocks the same way.
+struct Placement {
+  var x: UInt = 0
+  var y: UInt = 0
+  /// Contexts of the directions currently being placed, innermost last.
+  var stack: [LayoutContext] = []
+
+  /// Position of the block being entered, a direction also opens a new context there.
+  mutating func enter(direction: Orientation?) -> Position {
+    if let direction {
+      stack.append(LayoutContext(x: x, y: y, orientation: direction))
+    }
+    return (x, y)
+  }
+
+  mutating func exit(isDirection: Bool, size: Container) {
     // For orientation blocks, pop the layout context and update parent position
-    if block is DirectionGroup {
-      if let context = layoutStack.popLast(),
-        let size = sizes[currentId]
-      {
+    if isDirection {
+      if let context = stack.popLast() {
         switch context.orientation {
         case .horizontal:
-          currentX = context.x + size.width
-          currentY = context.y
+          x = context.x + size.width
+          y = context.y
         case .vertical:
-          currentX = context.x
-          currentY = context.y + size.height
+          x = context.x
+          y = context.y + size.height
         }
       }
     } else {
       // For regular blocks, update current position based on their own orientation
-      if let size = sizes[currentId] {
-        switch size.orientation {
-        case .horizontal:
-          currentX += size.width
-        case .vertical:
-          currentY += size.height
-        }
+      switch size.orientation {
+      case .horizontal:
+        x += size.width
+      case .vertical:
+        y += size.height
       }
     }
   }
 
-  mutating func before(child block: some Block) {
-    // For child blocks, reset to the current container's position
-    if let context = layoutStack.last {
-      currentX = context.x
-      currentY = context.y
+  // For child blocks, reset to the current container's position
+  mutating func enterChild() {
+    if let context = stack.last {
+      x = context.x
+      y = context.y
     }
   }
 
-  mutating func after(child block: some Block) {
-    // After processing a child, update the container's position for the next child
-    if let childSize = sizes[currentId], layoutStack.count > 0 {
-      let index = layoutStack.count - 1
-      let context = layoutStack[index]
+  // After processing a child, update the container's position for the next child
+  mutating func exitChild(size: Container) {
+    if stack.count > 0 {
+      let index = stack.count - 1
+      let context = stack[index]
       switch context.orientation {
       case .horizontal:
-        layoutStack[index] = LayoutContext(
-          x: context.x + childSize.width, y: context.y, orientation: context.orientation)
+        stack[index] = LayoutContext(x: context.x + size.width, y: context.y, orientation: context.orientation)
       case .vertical:
-        layoutStack[index] = LayoutContext(
-          x: context.x, y: context.y + childSize.height, orientation: context.orientation)
+        stack[index] = LayoutContext(x: context.x, y: context.y + size.height, orientation: context.orientation)
       }
     }
   }
 }
-
-struct LayoutContext {
-  let x: UInt
-  let y: UInt
-  let orientation: Orientation
-}
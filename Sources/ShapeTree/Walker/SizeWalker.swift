@@ -1,61 +1,73 @@
 import Logging
 
 @MainActor
-struct SizeWalker: Walker {
+struct SizeWalker<Metrics: FontMetrics>: Walker {
   var currentId: Hash = 0
   var parentId: Hash = 0
-  var sizes: [Hash: Size] = [:]
-  var parents: [Hash: Hash] = [:]
-  var names: [Hash: String] = [:]
+  var currentIndex: NodeIndex = NodeTable.none
+  var parentIndex: NodeIndex = NodeTable.none
+  var nextIndex: NodeIndex = 0
+  var sizes = NodeColumn<Size>()
+  /// Hash of everything measuring a subtree reads: block types, layout
+  /// attributes, text and orientation. Equal fingerprints measure the same.
+  var fingerprints = NodeColumn<Hash>()
   var currentOrentation: Orientation = .vertical
-  var attributes: [Hash: Attributes]
   let logger: Logger
-  let settings: FontMetrics
+  let settings: Metrics
+  /// When `false` every node keeps the size of its own content, for a
+  /// ``LayoutSnapshot`` that adds up its containers later.
+  let foldsChildren: Bool
 
-  init(settings: FontMetrics, attributes: [Hash: Attributes], logLevel: Logger.Level = .trace) {
+  /// Sizing reads attributes straight from the blocks so it can share a
+  /// traversal with the ``AttributesWalker`` that builds the node table.
+  init(settings: Metrics, foldsChildren: Bool = true, logLevel: Logger.Level = .trace) {
     self.settings = settings
-    self.attributes = attributes
+    self.foldsChildren = foldsChildren
     self.logger = Logger.create(logLevel: logLevel, label: "SizeWalker")
   }
 
   mutating func before(_ block: some Block) {
-    names[currentId] = "\(type(of: block))"
-    parents[currentId] = parentId
-
-    if let attributes = attributes[currentId] {
-      apply(attributes: attributes, block)
-    } else if block is any HasAttributes {
-      // Skip over attributes blocks
-    } else if let text = block as? Text {
+    // Sizes are appended in pre-order so the column lines up with the node table.
+    sizes.append(.unknown(currentOrentation))
+    var fingerprint = Hash(UInt(bitPattern: ObjectIdentifier(type(of: block))))
+    defer { fingerprints.append(mix(fingerprint, currentOrentation == .horizontal ? 1 : 0)) }
+
+    switch block._kind {
+    case .attributed(let attributes, let text):
+      apply(attributes: attributes, text: text)
+      fingerprint = mix(fingerprint, attributes.layoutHash)
+      if let text {
+        fingerprint = mix(fingerprint, hash(text.label))
+      }
+    case .text(let text):
+      fingerprint = mix(fingerprint, hash(text.label))
       guard !text.label.contains("\n") else {
         fatalError("New lines not supported yet")
       }
-      sizes[currentId] = .known(
+      sizes[currentIndex] = .known(
         Container(
           height: text.height(1, using: settings),
           width: text.width(1, using: settings),
           orientation: currentOrentation))
-    } else if let group = block as? BlockGroup {
-      if group.children.count < 1 {
+    case .group(let isEmpty):
+      if isEmpty {
         // Handle empty groups from optional blocks.
-        sizes[currentId] = .known(Container(height: 0, width: 0, orientation: currentOrentation))
-      } else {
-        sizes[currentId] = .unknown(currentOrentation)
+        sizes[currentIndex] = .known(Container(height: 0, width: 0, orientation: currentOrentation))
       }
-    } else if let group = block as? DirectionGroup {
-      currentOrentation = group.orientation
-      sizes[currentId] = .unknown(currentOrentation)
-    } else {
-      // User defined composed
-      sizes[currentId] = .unknown(currentOrentation)
+    case .direction(let orientation):
+      currentOrentation = orientation
+      sizes[currentIndex] = .unknown(currentOrentation)
+    case .composed:
+      // A user defined block, its size is unknown until its children are measured.
+      break
     }
   }
 
-  private mutating func apply(attributes: Attributes, _ block: some Block) {
+  private mutating func apply(attributes: Attributes, text: Text?) {
     var width: UInt = 0
     var height: UInt = 0
 
-    if let text = block.layer as? Text {
+    if let text {
       width = text.width(attributes.scale ?? settings.scale, using: settings)
       height = text.height(attributes.scale ?? settings.scale, using: settings)
     } else {
@@ -82,27 +94,53 @@ struct SizeWalker: Walker {
       height += (padding.top ?? 0) + (padding.bottom ?? 0)
     }
 
-    sizes[currentId] = .known(Container(height: height, width: width, orientation: currentOrentation))
+    sizes[currentIndex] = .known(Container(height: height, width: width, orientation: currentOrentation))
   }
 
   mutating func after(_ block: some Block) {
-    guard let p = sizes[parentId], let me = sizes[currentId] else { return }
-    switch (p, me) {
+    guard parentIndex != NodeTable.none else { return }
+    fingerprints[parentIndex] = mix(fingerprints[parentIndex], fingerprints[currentIndex])
+    if foldsChildren {
+      sizes[parentIndex] = sizes[parentIndex].adding(child: sizes[currentIndex])
+    }
+  }
+
+  mutating func before(child block: some Block) {}
+  mutating func after(child block: some Block) {}
+}
+
+enum Size: Equatable, Sendable, CustomStringConvertible {
+  case unknown(Orientation)
+  case known(Container)
+
+  var orientation: Orientation {
+    switch self {
+    case .unknown(let o):
+      return o
+    case .known(let container):
+      return container.orientation
+    }
+  }
+
+  /// Grows a container by a child that has been measured. Children can be
+  /// added in any order, a container only sums and takes maximums.
+  func adding(child: Size) -> Size {
+    switch (self, child) {
     case (.unknown(let o), .known(let container)):
-      sizes[parentId] = .known(Container(height: container.height, width: container.width, orientation: o))
+      return .known(Container(height: container.height, width: container.width, orientation: o))
     case (.known(let parentContainer), .known(let myContainer)):
       switch parentContainer.orientation {
       case .horizontal:
         let newWidth = myContainer.width + parentContainer.width
         let newHeight = max(myContainer.height, parentContainer.height)
 
-        sizes[parentId] = .known(
+        return .known(
           Container(
             height: newHeight,
             width: newWidth,
             orientation: .horizontal))
       case .vertical:
-        sizes[parentId] = .known(
+        return .known(
           Container(
             height: myContainer.height + parentContainer.height,
             width: max(myContainer.width, parentContainer.width),
@@ -113,14 +151,6 @@ struct SizeWalker: Walker {
     }
   }
 
-  mutating func before(child block: some Block) {}
-  mutating func after(child block: some Block) {}
-}
-
-enum Size: Equatable, CustomStringConvertible {
-  case unknown(Orientation)
-  case known(Container)
-
   var description: String {
     switch self {
     case .unknown(let o):
@@ -131,7 +161,7 @@ enum Size: Equatable, CustomStringConvertible {
   }
 }
 
-public struct Container: Equatable {
+public struct Container: Hashable, Sendable {
   public var height: UInt
   public var width: UInt
   public var orientation: Orientation
@@ -142,3 +172,28 @@ public struct Container: Equatable {
     self.orientation = orientation
   }
 }
+
+extension Attributes {
+  // Only the attributes that change a block's size, colors are left out.
+  fileprivate var layoutHash: Hash {
+    var h = mix(width.layoutHash, height.layoutHash)
+    h = mix(h, Hash(scale ?? 0))
+    if let padding {
+      h = mix(h, Hash(padding.top ?? 0))
+      h = mix(h, Hash(padding.right ?? 0))
+      h = mix(h, Hash(padding.bottom ?? 0))
+      h = mix(h, Hash(padding.left ?? 0))
+    }
+    return h
+  }
+}
+
+extension Sizing {
+  fileprivate var layoutHash: Hash {
+    switch self {
+    case .fixed(let value): mix(1, Hash(value))
+    case .fit: 2
+    case .grow: 3
+    }
+  }
+}
@@ -4,114 +4,168 @@ import Logging
 public protocol Walker {
   var currentId: Hash { get set }
   var parentId: Hash { get set }
+  /// Pre-order ``NodeIndex`` of the block being visited.
+  var currentIndex: NodeIndex { get set }
+  var parentIndex: NodeIndex { get set }
+  /// The index handed to the next block entered, i.e. the number of nodes seen so far.
+  var nextIndex: NodeIndex { get set }
   mutating func before(_ block: some Block)
   mutating func after(_ block: some Block)
   mutating func before(child block: some Block)
   mutating func after(child block: some Block)
+  /// Asked right after ``before(_:)``. Returns how many descendants of the current
+  /// block this walker already has results for, or `0` to visit them as usual.
+  mutating func descendantsToSkip() -> NodeIndex
+  /// Called instead of visiting the descendants counted by ``descendantsToSkip()``.
+  mutating func skipDescendants()
+  /// The ID of the node at `index` if an earlier walk already computed it, so
+  /// the walk does not have to mix it again. `nil` computes it as usual.
+  func knownId(at index: NodeIndex) -> Hash?
 }
 
-@MainActor
-public func calculateLayout(_ block: some Block, height: UInt, width: UInt, settings: FontMetrics) -> Layout {
-  var attributesWalker = AttributesWalker()
-  block.walk(with: &attributesWalker)
+extension Walker {
+  public mutating func descendantsToSkip() -> NodeIndex { 0 }
+  public mutating func skipDescendants() {}
+  public func knownId(at index: NodeIndex) -> Hash? { nil }
+}
 
-  guard let rootChildren = attributesWalker.tree[0], !rootChildren.isEmpty else {
-    fatalError("Layout tree has no root element")
+/// The traversals ``calculateLayout(_:height:width:settings:cache:timed:)`` makes, in order.
+public enum LayoutPass: Sendable {
+  /// Attributes and intrinsic sizes.
+  case measure
+  /// Grown sizes and positions.
+  case place
+}
+
+/// Lays out `block` in a `height` by `width` window.
+///
+/// Pass the same `cache` every frame to reuse the grown sizes and positions of
+/// subtrees that did not change. Measuring still visits every block since that
+/// is how changes are found. `timed` is handed how long each pass took.
+@MainActor
+public func calculateLayout(
+  _ block: some Block, height: UInt, width: UInt, settings: some FontMetrics, cache: LayoutCache? = nil,
+  timed: ((LayoutPass, Duration) -> Void)? = nil
+) -> Layout {
+  var lap = timed.map { _ in ContinuousClock.now }
+  func finish(_ pass: LayoutPass) {
+    guard let timed, let started = lap else { return }
+    let now = ContinuousClock.now
+    timed(pass, now - started)
+    lap = now
   }
-  let root = rootChildren[0]
 
-  var sizer = SizeWalker(settings: settings, attributes: attributesWalker.attributes)
-  block.walk(with: &sizer)
+  // Attributes and intrinsic sizes only depend on a block and its descendants
+  // so both are collected in the first traversal.
+  var measure = Walkers(AttributesWalker(), SizeWalker(settings: settings))
+  block.walk(with: &measure)
+  let (attributesWalker, sizer) = (consume measure).walkers
+  finish(.measure)
 
-  guard let rootSize = sizer.sizes[root] else {
-    fatalError("Root element has no computed size")
-  }
-  let orientation: Orientation
-  switch rootSize {
-  case .known(let container):
-    orientation = container.orientation
-  case .unknown(let o):
-    orientation = o
+  let nodes = attributesWalker.nodes
+  guard !nodes.isEmpty else {
+    fatalError("Layout tree has no root element")
   }
-  sizer.sizes[root] = .known(Container(height: height, width: width, orientation: orientation))
-
-  let containers = sizer.sizes.convert()
+  let root = nodes.root
 
-  var grower = GrowWalker(
-    sizes: containers,
-    attributes: attributesWalker.attributes,
-    tree: attributesWalker.tree
-  )
-  block.walk(with: &grower)
+  let rootSize = Container(height: height, width: width, orientation: sizer.sizes[root].orientation)
 
-  var positioner = PositionWalker(sizes: grower.sizes, attributes: attributesWalker.attributes)
-  block.walk(with: &positioner)
+  // Growing needs every intrinsic size, positioning needs the grown sizes. The
+  // grower settles a container's children when it is entered so positions can
+  // be placed in the same second traversal.
+  cache?.prepare(fingerprints: sizer.fingerprints, settings: settings)
+  let grower = GrowWalker(sizes: sizer.sizes.convert(root: rootSize), nodes: nodes, cache: cache)
+  var place = Walkers(grower, PositionWalker(following: grower))
+  block.walk(with: &place)
+  let (_, positioner) = (consume place).walkers
+  cache?.commit(sizes: grower.sizes, positions: positioner.positions)
+  finish(.place)
 
   return Layout(
+    nodes: nodes,
     positions: positioner.positions,
-    sizes: grower.sizes,
-    attributes: attributesWalker.attributes,
-    tree: attributesWalker.tree
+    sizes: grower.sizes
   )
 }
 
-extension [Hash: Size] {
-  func convert() -> [Hash: Container] {
-    var containers: [Hash: Container] = [:]
-    for (key, value) in self {
+extension NodeColumn<Size> {
+  /// Unwraps the measured sizes, optionally replacing the root with the size of the window.
+  func convert(root: Container? = nil) -> NodeColumn<Container> {
+    var containers = NodeColumn<Container>()
+    containers.reserveCapacity(count)
+    for (index, value) in zip(indices, self) {
+      if index == startIndex, let root {
+        containers.append(root)
+        continue
+      }
       switch value {
       case .known(let container):
-        containers[key] = container
+        containers.append(container)
       case .unknown(_):
-        fatalError("\(#function) \(key) \(value)")
+        fatalError("\(#function) \(index) \(value)")
       }
     }
     return containers
   }
 }
 
+extension Walker {
+  fileprivate mutating func enter(_ id: Hash) -> (id: Hash, index: NodeIndex) {
+    let saved = (parentId, parentIndex)
+    parentId = currentId
+    parentIndex = currentIndex
+    currentId = id
+    currentIndex = nextIndex
+    nextIndex += 1
+    return saved
+  }
+
+  fileprivate mutating func exit(_ saved: (id: Hash, index: NodeIndex)) {
+    currentId = parentId
+    currentIndex = parentIndex
+    parentId = saved.id
+    parentIndex = saved.index
+  }
+}
+
 extension Block {
-  func id(current: Hash, _ index: Int? = nil) -> UInt64 {
-    // Not sure the best way to combine hashes together.
+  /// The parent's ID mixed with the type of the block and its position among its siblings.
+  func id(current: Hash, _ index: Int? = nil) -> Hash {
+    let type = mix(current, typeId(of: Self.self))
     if let index {
-      return hash(current | hash("\(type(of: self))\(index)"))
+      return mix(type, Hash(index))
     }
-    return hash(current | hash("\(type(of: self))"))
+    return type
+  }
+
+  private func id(for walker: some Walker, _ index: Int? = nil) -> Hash {
+    walker.knownId(at: walker.nextIndex) ?? id(current: walker.currentId, index)
   }
 
   private func _walk(with walker: inout some Walker, _ orientation: Orientation) {
     walker.before(self)
-    if let group = self as? DirectionGroup {
-      self.layer.walk(with: &walker, group.orientation)
-    } else if let group = self as? BlockGroup {
-      for (i, child) in group.children.enumerated() {
-        let parent = walker.parentId
-        walker.parentId = walker.currentId
-        walker.currentId = child.id(current: walker.currentId, i)
-        walker.before(child: child)
-        child._walk(with: &walker, orientation)
-        walker.after(child: child)
-        walker.currentId = walker.parentId
-        walker.parentId = parent
-      }
-    } else if self as? Text != nil {
-      // Leaf Nodes
-    } else if let attributedBlock = self as? any HasAttributes {
-      if !(attributedBlock.layer is Text) {  // Prevents double rendering for now.
-        self.layer.walk(with: &walker)
-      }
-    } else {  // Composed
-      self.layer.walk(with: &walker, orientation)
+    let skipped = walker.descendantsToSkip()
+    if skipped > 0 {
+      walker.skipDescendants()
+      walker.nextIndex += skipped
+    } else {
+      _walkLayer(with: &walker, orientation)
     }
     walker.after(self)
   }
 
+  /// Walks `self` as the `index`th child of a group, wrapped in the child events.
+  func walk(asChildAt index: Int, with walker: inout some Walker, _ orientation: Orientation) {
+    let saved = walker.enter(id(for: walker, index))
+    walker.before(child: self)
+    _walk(with: &walker, orientation)
+    walker.after(child: self)
+    walker.exit(saved)
+  }
+
   public func walk(with walker: inout some Walker, _ orientation: Orientation = .vertical) {
-    let parent = walker.parentId
-    walker.parentId = walker.currentId
-    walker.currentId = self.id(current: walker.currentId)
+    let saved = walker.enter(id(for: walker))
     _walk(with: &walker, orientation)
-    walker.currentId = walker.parentId
-    walker.parentId = parent
+    walker.exit(saved)
   }
 }
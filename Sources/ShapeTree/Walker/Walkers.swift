@@ -0,0 +1,120 @@
+/// Runs several walkers in a single traversal of the block tree.
+///
+/// Every event is forwarded to the walkers in the order they were given, so a
+/// walker may rely on the walkers before it having already seen the same node.
+/// This saves repeating the casts, child enumeration and ID hashing that
+/// ``Block/walk(with:_:)`` does per node for every separate walk.
+///
+/// Copies are independent: a copy shares the walkers until either is walked,
+/// which gives that one walkers of its own.
+@MainActor
+public struct Walkers<each W: Walker>: Walker {
+  public var currentId: Hash = 0
+  public var parentId: Hash = 0
+  public var currentIndex: NodeIndex = NodeTable.none
+  public var parentIndex: NodeIndex = NodeTable.none
+  public var nextIndex: NodeIndex = 0
+  private var shared: (repeat WalkerBox<each W>)
+  // Referenced by every copy sharing `shared`.
+  private var owner = Owner()
+
+  public init(_ walker: repeat each W) {
+    self.shared = (repeat WalkerBox(each walker))
+  }
+
+  /// The wrapped walkers with everything they have collected so far.
+  public var walkers: (repeat each W) {
+    (repeat (each shared).walker)
+  }
+
+  /// The walkers to forward an event to, copied first while another copy shares them.
+  private var boxes: (repeat WalkerBox<each W>) {
+    mutating get {
+      if !isKnownUniquelyReferenced(&owner) {
+        owner = Owner()
+        shared = (repeat WalkerBox((each shared).walker))
+      }
+      return shared
+    }
+  }
+
+  public mutating func before(_ block: some Block) {
+    for box in repeat each boxes {
+      box.move(to: self)
+      box.walker.before(block)
+    }
+  }
+
+  public mutating func after(_ block: some Block) {
+    for box in repeat each boxes {
+      box.move(to: self)
+      box.walker.after(block)
+    }
+  }
+
+  public mutating func before(child block: some Block) {
+    for box in repeat each boxes {
+      box.move(to: self)
+      box.walker.before(child: block)
+    }
+  }
+
+  public mutating func after(child block: some Block) {
+    for box in repeat each boxes {
+      box.move(to: self)
+      box.walker.after(child: block)
+    }
+  }
+
+  /// Descendants are only skipped when every walker can skip the same number.
+  public mutating func descendantsToSkip() -> NodeIndex {
+    var agreed: NodeIndex? = nil
+    for box in repeat each boxes {
+      box.move(to: self)
+      let count = box.walker.descendantsToSkip()
+      guard count > 0, agreed == nil || agreed == count else { return 0 }
+      agreed = count
+    }
+    return agreed ?? 0
+  }
+
+  public mutating func skipDescendants() {
+    for box in repeat each boxes {
+      box.move(to: self)
+      box.walker.skipDescendants()
+    }
+  }
+
+  /// The first ID known by any of the walkers.
+  public func knownId(at index: NodeIndex) -> Hash? {
+    for box in repeat each shared {
+      if let id = box.walker.knownId(at: index) {
+        return id
+      }
+    }
+    return nil
+  }
+}
+
+// The walkers live behind a reference so each event mutates them in place
+// instead of copying them, and their buffers, in and out of the tuple.
+@MainActor
+private final class WalkerBox<W: Walker> {
+  var walker: W
+
+  init(_ walker: W) {
+    self.walker = walker
+  }
+
+  func move(to cursor: some Walker) {
+    walker.currentId = cursor.currentId
+    walker.parentId = cursor.parentId
+    walker.currentIndex = cursor.currentIndex
+    walker.parentIndex = cursor.parentIndex
+    walker.nextIndex = cursor.nextIndex
+  }
+}
+
+// Copies of `Walkers` sharing their boxes share one of these, so a walk can tell
+// whether it has to copy the walkers first.
+private final class Owner {}
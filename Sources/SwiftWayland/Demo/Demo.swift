@@ -9,6 +9,11 @@ func runDemo() async {
   let frameLogger = Logger.create(logLevel: .warning, label: "Frame")
   let keyLogger = Logger.create(logLevel: level, label: "Key")
   var ips: [String] = []
+  // Shows the frame times above the screen and prints where they went on exit.
+  let profiles = CommandLine.arguments.contains("--profile")
+  // The frame times and FPS only move when frames are drawn all the time.
+  Wayland.rendersContinuously = profiles
+  Wayland.profilesLayoutWalkers = profiles
 
   Wayland.setup()
   event_loop: for await ev in Wayland.events() {
@@ -16,7 +21,15 @@ func runDemo() async {
     case .frame(let height, let width):
       Wayland.preDraw()
       let block = Screen(scale: 2, ips: ips, fps: String(format: "%.1f FPS", Wayland.currentFPS))
-      Wayland.render(block)
+      if profiles {
+        Wayland.render(
+          Direction(.vertical) {
+            FrameGraph()
+            block
+          })
+      } else {
+        Wayland.render(block)
+      }
       Wayland.postDraw()
       if Wayland.elapsed > Wayland.refresh_rate {
         frameLogger.warning("\(Wayland.elapsed)")
@@ -33,6 +46,7 @@ func runDemo() async {
         Task {
           let r = await getIps()
           ips = r
+          Wayland.invalidate()
         }
       default:
         ()
@@ -40,6 +54,13 @@ func runDemo() async {
     }
   }
 
+  if profiles {
+    for phase in FramePhase.allCases {
+      guard let stats = Wayland.profiler.stats(phase) else { continue }
+      print("\(phase): min \(stats.min) avg \(stats.average) p99 \(stats.p99) over \(stats.samples) frames")
+    }
+  }
+
   // Read the final state
   switch Wayland.state {
   case .error(let reason):
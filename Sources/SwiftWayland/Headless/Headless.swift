@@ -0,0 +1,34 @@
+import Fixtures
+import Foundation
+import ShapeTree
+import Wayland
+
+/// Draws `frames` frames of the demo screen without a compositor and writes
+/// the last one to `output` as a PPM.
+@MainActor
+func runHeadless(frames: Int, output: String) {
+  // The software backend draws into its canvas without any setup.
+  if Wayland.backend == .gl {
+    do {
+      try Wayland.setupHeadless(width: Wayland.windowWidth, height: Wayland.windowHeight)
+    } catch {
+      print("error: \(error)")
+      return
+    }
+  }
+  Wayland.skipsUnchangedFrames = false
+  let clock = ContinuousClock()
+  let duration = clock.measure {
+    for _ in 0..<frames {
+      Wayland.preDraw()
+      Wayland.render(Screen(scale: 2, ips: [], fps: String(format: "%.1f FPS", Wayland.currentFPS)))
+      Wayland.postDraw()
+    }
+  }
+  print("\(frames) frames in \(duration), \(Wayland.frameStats.drawCalls) draw calls per frame")
+  do {
+    try Wayland.readPixels().write(ppm: output)
+  } catch {
+    print("error: \(error)")
+  }
+}
@@ -4,8 +4,16 @@ import Wayland
 @MainActor
 struct SwiftWayland {
   static func main() async {
-    // Use --toolbar flag to run in toolbar mode.
-    if CommandLine.arguments.contains("--toolbar") {
+    let arguments = CommandLine.arguments
+    // Use --toolbar flag to run in toolbar mode, --headless to render without a display, --software on the CPU.
+    // --profile graphs frame times in the demo.
+    if arguments.contains("--software") {
+      Wayland.backend = .software
+    }
+    if arguments.contains("--headless") {
+      let frames = value(after: "--frames", in: arguments).flatMap { Int($0) } ?? 60
+      runHeadless(frames: frames, output: value(after: "--output", in: arguments) ?? "frame.ppm")
+    } else if arguments.contains("--toolbar") {
       Wayland.mode = .toolbar
       await runToolbar()
     } else {
@@ -13,4 +21,9 @@ struct SwiftWayland {
       await runDemo()
     }
   }
+
+  static func value(after option: String, in arguments: [String]) -> String? {
+    guard let index = arguments.firstIndex(of: option), index + 1 < arguments.endIndex else { return nil }
+    return arguments[index + 1]
+  }
 }
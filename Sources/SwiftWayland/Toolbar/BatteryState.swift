@@ -1,5 +1,6 @@
 import NIOFileSystem
 import RegexBuilder
+import Wayland
 
 struct SnapShot {
   let batteryPercent: Int
@@ -33,7 +34,10 @@ actor SystemState {
         return
       }
       let percent = Int((now / full) * 100.0)
-      batteryPercent = percent
+      if percent != batteryPercent {
+        batteryPercent = percent
+        Wayland.invalidate()
+      }
     } catch {
       print("failed to read battery info")
       return
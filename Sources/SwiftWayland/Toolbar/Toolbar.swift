@@ -10,6 +10,14 @@ func runToolbar() async {
 
   let system = SystemState()
   Wayland.setup()
+  // The clock shows seconds, so it needs a frame when the next one starts.
+  let clock = Task {
+    while !Task.isCancelled {
+      let now = Date().timeIntervalSince1970
+      try? await Task.sleep(for: .seconds(now.rounded(.up) - now))
+      Wayland.invalidate()
+    }
+  }
   event_loop: for await ev in Wayland.events() {
     switch ev {
     case .frame:
@@ -25,6 +33,8 @@ func runToolbar() async {
     }
   }
 
+  clock.cancel()
+
   // Read the final state
   switch Wayland.state {
   case .error(let reason):
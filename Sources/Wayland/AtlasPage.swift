@@ -0,0 +1,38 @@
+/// The layout of one RGBA texture atlas page.
+///
+/// Every page reserves a block of solid white texels to the right of its
+/// content. Plain quads sample the middle of that block and are tinted by their
+/// color, so quads and glyphs on the same page share one texture and one draw.
+/// Pages added later, for images or other fonts, are laid out the same way.
+struct AtlasPage: Equatable {
+  /// Side of the white block. The middle texel is surrounded by white so
+  /// neither nearest nor linear filtering reaches the content next to it.
+  static let whiteSize = 3
+
+  let contentWidth: Int
+  let contentHeight: Int
+
+  init(contentWidth: Int, contentHeight: Int) {
+    self.contentWidth = contentWidth
+    self.contentHeight = contentHeight
+  }
+
+  var width: Int { contentWidth + Self.whiteSize }
+  var height: Int { max(contentHeight, Self.whiteSize) }
+
+  /// Texture coordinate of the middle of the white block, used for both corners of a plain quad.
+  var whiteUV: (Float, Float) {
+    let middle = Float(Self.whiteSize) / 2
+    return ((Float(contentWidth) + middle) / Float(width), middle / Float(height))
+  }
+
+  /// Texels of an empty page: transparent content and the white block, `width * height` RGBA texels.
+  func blankPixels() -> [UInt8] {
+    var pixels = [UInt8](repeating: 0, count: width * height * 4)
+    for y in 0..<Self.whiteSize {
+      let row = (y * width + contentWidth) * 4
+      pixels[row..<row + Self.whiteSize * 4] = ArraySlice(repeating: 255, count: Self.whiteSize * 4)
+    }
+    return pixels
+  }
+}
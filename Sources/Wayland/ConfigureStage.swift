@@ -0,0 +1,32 @@
+/// Configures received since the last frame started, applied together when
+/// the next one starts.
+///
+/// A drag resize configures far more often than frames are drawn. Only the
+/// last size and serial are kept, acking a serial acks every configure before
+/// it, so the frame is resized, acked and laid out once, at the size the
+/// compositor asked for last.
+struct ConfigureStage {
+  struct Size: Equatable {
+    let width: UInt
+    let height: UInt
+  }
+
+  private(set) var size: Size? = nil
+  private(set) var serial: UInt32? = nil
+
+  /// A zero size leaves it to the client, the current one is kept.
+  mutating func stage(width: Int32, height: Int32) {
+    guard width > 0, height > 0 else { return }
+    size = Size(width: UInt(width), height: UInt(height))
+  }
+
+  mutating func stage(serial: UInt32) {
+    self.serial = serial
+  }
+
+  /// Empties the stage. `resize` is only set when the size differs from `current`.
+  mutating func take(current: Size) -> (resize: Size?, ack: UInt32?) {
+    defer { self = ConfigureStage() }
+    return (size == current ? nil : size, serial)
+  }
+}
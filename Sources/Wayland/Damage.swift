@@ -0,0 +1,141 @@
+/// A rectangle of the window in buffer coordinates, origin at the top left.
+struct DamageRect: Equatable {
+  var x: UInt
+  var y: UInt
+  var width: UInt
+  var height: UInt
+
+  var isEmpty: Bool { width == 0 || height == 0 }
+
+  func intersects(_ other: DamageRect) -> Bool {
+    x < other.x + other.width && other.x < x + width && y < other.y + other.height && other.y < y + height
+  }
+
+  func union(_ other: DamageRect) -> DamageRect {
+    let minX = min(x, other.x)
+    let minY = min(y, other.y)
+    return DamageRect(
+      x: minX, y: minY,
+      width: max(x + width, other.x + other.width) - minX,
+      height: max(y + height, other.y + other.height) - minY)
+  }
+
+  func intersection(_ other: DamageRect) -> DamageRect? {
+    let minX = max(x, other.x)
+    let minY = max(y, other.y)
+    let maxX = min(x + width, other.x + other.width)
+    let maxY = min(y + height, other.y + other.height)
+    guard minX < maxX, minY < maxY else { return nil }
+    return DamageRect(x: minX, y: minY, width: maxX - minX, height: maxY - minY)
+  }
+}
+
+/// A handful of non-overlapping rectangles. Overlapping rectangles are merged
+/// and past ``limit`` everything collapses into one bounding box, since every
+/// rectangle costs a scissored pass over the frame.
+struct DamageRegion {
+  static let limit = 8
+  private(set) var rects: [DamageRect] = []
+
+  mutating func add(_ rect: DamageRect) {
+    guard !rect.isEmpty else { return }
+    var merged = rect
+    var i = 0
+    while i < rects.count {
+      if rects[i].intersects(merged) {
+        // The union may now overlap rectangles that were already checked.
+        merged = merged.union(rects.remove(at: i))
+        i = 0
+      } else {
+        i += 1
+      }
+    }
+    rects.append(merged)
+    if rects.count > Self.limit {
+      rects = [rects.dropFirst().reduce(rects[0]) { $0.union($1) }]
+    }
+  }
+}
+
+@MainActor
+extension RenderCommand {
+  /// Every pixel the command can touch.
+  var bounds: DamageRect {
+    switch self {
+    case .quad(let quad):
+      let minX = min(quad.dst_p0.0, quad.dst_p1.0)
+      let minY = min(quad.dst_p0.1, quad.dst_p1.1)
+      return DamageRect(
+        x: UInt(max(minX, 0)), y: UInt(max(minY, 0)),
+        width: UInt(abs(quad.dst_p1.0 - quad.dst_p0.0).rounded(.up)),
+        height: UInt(abs(quad.dst_p1.1 - quad.dst_p0.1).rounded(.up)))
+    case .text(let text):
+      let count = UInt(text.text.utf8.count)
+      let advance = (Wayland.glyphW + Wayland.glyphSpacing) * text.scale
+      return DamageRect(
+        x: text.pos.x, y: text.pos.y,
+        width: count > 0 ? count * advance - Wayland.glyphSpacing * text.scale : 0,
+        height: Wayland.glyphH * text.scale)
+    }
+  }
+
+  /// Rectangles covering every pixel that can differ between drawing `old` and `new`.
+  ///
+  /// Commands are painted in order, so a pixel outside the bounds of every
+  /// command that differs is painted by the same sequence in both frames.
+  static func damage(from old: [RenderCommand], to new: [RenderCommand]) -> DamageRegion {
+    var region = DamageRegion()
+    if old.count == new.count {
+      for (before, after) in zip(old, new) where before != after {
+        region.add(before.bounds)
+        region.add(after.bounds)
+      }
+      return region
+    }
+    // Insertions and removals shift everything after them so only the common
+    // prefix and suffix can be matched up.
+    var prefix = 0
+    while prefix < old.count, prefix < new.count, old[prefix] == new[prefix] {
+      prefix += 1
+    }
+    var suffix = 0
+    while suffix < old.count - prefix, suffix < new.count - prefix,
+      old[old.count - 1 - suffix] == new[new.count - 1 - suffix]
+    {
+      suffix += 1
+    }
+    for command in old[prefix..<old.count - suffix] {
+      region.add(command.bounds)
+    }
+    for command in new[prefix..<new.count - suffix] {
+      region.add(command.bounds)
+    }
+    return region
+  }
+}
+
+/// Damage of the last few presented frames, newest first, so a back buffer
+/// reported by `EGL_EXT_buffer_age` can be brought up to date.
+struct DamageHistory {
+  static let depth = 4
+  private var frames: [[DamageRect]] = []
+
+  mutating func record(_ damage: [DamageRect]) {
+    frames.insert(damage, at: 0)
+    if frames.count > Self.depth {
+      frames.removeLast()
+    }
+  }
+
+  /// What to redraw in a buffer last drawn `age` frames ago, `nil` to redraw everything.
+  func repaint(age: Int) -> [DamageRect]? {
+    guard age > 0, age <= frames.count else { return nil }
+    var region = DamageRegion()
+    for frame in frames.prefix(age) {
+      for rect in frame {
+        region.add(rect)
+      }
+    }
+    return region.rects
+  }
+}
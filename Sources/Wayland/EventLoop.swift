@@ -0,0 +1,161 @@
+import CWaylandClient
+import Foundation
+
+/// Where ``EventLoop`` reads events from, the display outside of tests.
+protocol EventSource: Sendable {
+  /// Readable once there are events to read.
+  var fd: Int32 { get }
+  /// Announces a read, `false` while events already read wait to be dispatched.
+  func prepareRead() -> Bool
+  func cancelRead()
+  /// Reads what arrived into the queue, `false` once the connection is lost.
+  func readEvents() -> Bool
+  /// Sends the requests made while dispatching.
+  func flush()
+  /// Runs the listeners of the events read, `false` once the connection is lost.
+  @MainActor func dispatchPending() -> Bool
+}
+
+/// The default queue of ``Wayland/display``.
+struct WaylandDisplay: EventSource {
+  var fd: Int32 { unsafe wl_display_get_fd(Wayland.display) }
+
+  func prepareRead() -> Bool {
+    unsafe wl_display_prepare_read(Wayland.display) == 0
+  }
+
+  func cancelRead() {
+    unsafe wl_display_cancel_read(Wayland.display)
+  }
+
+  func readEvents() -> Bool {
+    unsafe wl_display_read_events(Wayland.display) != -1
+  }
+
+  func flush() {
+    _ = unsafe wl_display_flush(Wayland.display)
+  }
+
+  @MainActor func dispatchPending() -> Bool {
+    unsafe wl_display_dispatch_pending(Wayland.display) != -1
+  }
+}
+
+/// Waits for events on a thread of its own and dispatches them on the main actor.
+///
+/// The thread follows `wl_display_prepare_read`: it announces a read, sleeps in
+/// `epoll_wait` until the display's fd or ``stop()`` wakes it, and reads the
+/// events into their queue. Dispatching them runs on the main actor, so the
+/// listeners share a thread with GL and the UI. The next read is announced once
+/// the dispatch is done, a read is refused while read events are queued.
+final class EventLoop<Source: EventSource>: @unchecked Sendable {
+  let source: Source
+  private let epoll: Int32
+  private let wake: Int32
+  private let dispatched = DispatchSemaphore(value: 0)
+  // Written on the main actor before `dispatched` is signalled, read by the thread after.
+  private var connected = true
+  private let failed: @MainActor @Sendable (String) -> Void
+
+  /// `failed` is called on the main actor when the connection is lost, the loop stops with it.
+  init(_ source: Source, failed: @escaping @MainActor @Sendable (String) -> Void) throws(WaylandError) {
+    let epoll = epoll_create1(Int32(EPOLL_CLOEXEC))
+    guard epoll >= 0 else { throw WaylandError.error(message: "epoll_create1 failed") }
+    let wake = eventfd(0, Int32(EFD_CLOEXEC))
+    guard wake >= 0 else {
+      close(epoll)
+      throw WaylandError.error(message: "eventfd failed")
+    }
+    for fd in [source.fd, wake] {
+      var event = epoll_event(events: EPOLLIN.rawValue, data: epoll_data_t(fd: fd))
+      guard unsafe epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) == 0 else {
+        close(wake)
+        close(epoll)
+        throw WaylandError.error(message: "Could not watch fd \(fd) with epoll")
+      }
+    }
+    self.source = source
+    self.epoll = epoll
+    self.wake = wake
+    self.failed = failed
+  }
+
+  // The thread holds on to the loop until it returns, so the fds outlive it and `stop()` stays safe.
+  deinit {
+    close(wake)
+    close(epoll)
+  }
+
+  func start() {
+    let thread = Thread { self.run() }
+    thread.name = "wayland-events"
+    thread.start()
+  }
+
+  /// Wakes the thread to end the loop, calling it after the loop ended does nothing.
+  func stop() {
+    var one: UInt64 = 1
+    _ = unsafe write(wake, &one, MemoryLayout<UInt64>.size)
+  }
+
+  private func run() {
+    while true {
+      while !source.prepareRead() {
+        guard dispatch() else { return }
+      }
+      source.flush()
+      switch waitForEvents() {
+      case .events:
+        break
+      case .stopped:
+        source.cancelRead()
+        return
+      case .failed(let error):
+        source.cancelRead()
+        report("Waiting for Wayland events failed, errno \(error).")
+        return
+      }
+      guard source.readEvents() else {
+        report("Lost the connection to the Wayland display.")
+        return
+      }
+      guard dispatch() else { return }
+    }
+  }
+
+  private func report(_ reason: String) {
+    Task { @MainActor in failed(reason) }
+  }
+
+  /// Dispatches on the main actor and waits for it, `false` once the connection is lost.
+  private func dispatch() -> Bool {
+    Task { @MainActor in
+      connected = source.dispatchPending()
+      if !connected {
+        failed("Lost the connection to the Wayland display.")
+      }
+      dispatched.signal()
+    }
+    dispatched.wait()
+    return connected
+  }
+
+  private enum Wakeup {
+    case events
+    case stopped
+    case failed(errno: Int32)
+  }
+
+  private func waitForEvents() -> Wakeup {
+    var event = epoll_event()
+    while true {
+      let count = unsafe epoll_wait(epoll, &event, 1, -1)
+      if count == 1 {
+        return event.data.fd == wake ? .stopped : .events
+      }
+      if count == -1, errno != EINTR {
+        return .failed(errno: errno)
+      }
+    }
+  }
+}
@@ -0,0 +1,91 @@
+/// Events waiting for the UI, taken a batch at a time.
+///
+/// Input is kept in order in a ring of ``capacity``. A `.frame` is not queued
+/// behind it, there is only ever the newest one, taken after the input so it
+/// draws all of it. A frame arriving while one waits replaces it with the size
+/// of the last configure, so a slow consumer never builds up a backlog of
+/// frames. Input arriving at a full ring is dropped.
+struct EventQueue {
+  let capacity: Int
+  private var ring: [WaylandEvent?]
+  private var head = 0
+  private var count = 0
+  private var frame: WaylandEvent? = nil
+  /// Frames replaced by a newer one before they were taken.
+  private(set) var coalescedFrames: UInt = 0
+  /// Input dropped because the ring was full.
+  private(set) var droppedEvents: UInt = 0
+
+  init(capacity: Int = 64) {
+    self.capacity = capacity
+    ring = Array(repeating: nil, count: capacity)
+  }
+
+  /// Events waiting to be taken.
+  var depth: Int { count + (frame == nil ? 0 : 1) }
+
+  mutating func push(_ event: WaylandEvent) {
+    switch event {
+    case .frame:
+      if frame != nil {
+        coalescedFrames += 1
+      }
+      frame = event
+    case .key:
+      guard count < capacity else {
+        droppedEvents += 1
+        return
+      }
+      ring[(head + count) % capacity] = event
+      count += 1
+    }
+  }
+
+  /// Moves the waiting events to `batch`, input first and the frame last.
+  mutating func drain(into batch: inout [WaylandEvent]) {
+    for offset in 0..<count {
+      let index = (head + offset) % capacity
+      if let event = ring[index] {
+        batch.append(event)
+      }
+      ring[index] = nil
+    }
+    head = (head + count) % capacity
+    count = 0
+    if let frame {
+      batch.append(frame)
+      self.frame = nil
+    }
+  }
+}
+
+/// The events of ``Wayland/events()``, read from ``Wayland``'s ``EventQueue``.
+///
+/// Waiting for events suspends once per batch rather than once per event.
+public struct WaylandEvents: AsyncSequence, Sendable {
+  public typealias Element = WaylandEvent
+
+  public struct AsyncIterator: AsyncIteratorProtocol, Sendable {
+    private var batch: [WaylandEvent] = []
+    private var index = 0
+
+    @MainActor
+    public mutating func next() async -> WaylandEvent? {
+      while index == batch.count {
+        batch.removeAll(keepingCapacity: true)
+        index = 0
+        Wayland.eventQueue.drain(into: &batch)
+        if batch.isEmpty {
+          guard Wayland.state.isRunning else { return nil }
+          await withCheckedContinuation { Wayland.eventsWaiting = $0 }
+        }
+      }
+      index += 1
+      return batch[index - 1]
+    }
+  }
+
+  public func makeAsyncIterator() -> AsyncIterator {
+    AsyncIterator()
+  }
+}
@@ -0,0 +1,177 @@
+import CGLES3
+
+/// Draw calls and instances of the last presented frame.
+public struct FrameStats: Equatable, Sendable {
+  /// `glDrawArraysInstanced` calls, once for every damaged rectangle the frame was drawn into.
+  public var drawCalls = 0
+  /// Quads and glyphs uploaded to the instance buffer.
+  public var instances = 0
+  /// Texts whose glyphs were copied from the glyph run cache.
+  public var glyphRunHits = 0
+  /// Texts whose glyphs were laid out again.
+  public var glyphRunMisses = 0
+
+  /// Share of the texts found in the glyph run cache, `0` without any text.
+  public var glyphRunHitRate: Double {
+    let texts = glyphRunHits + glyphRunMisses
+    return texts == 0 ? 0 : Double(glyphRunHits) / Double(texts)
+  }
+}
+
+/// Every quad and glyph of a frame in painter's order, uploaded at once.
+///
+/// Consecutive instances sampling the same texture share one draw, so a frame
+/// takes as many draw calls as it switches textures. Everything the
+/// ``RenderWalker`` draws comes from one atlas page, a single draw.
+@MainActor
+struct FrameBatch {
+  /// Instances `first..<first + count` drawn with `texture`.
+  struct Draw: Equatable {
+    let texture: GLuint
+    let first: Int
+    var count: Int
+  }
+
+  private(set) var instances: [QuadInstance] = []
+  private(set) var draws: [Draw] = []
+  /// Kept across frames, unlike the instances.
+  var glyphRuns = GlyphRunCache()
+  private(set) var glyphRunHits = 0
+  private(set) var glyphRunMisses = 0
+
+  var isEmpty: Bool { instances.isEmpty }
+
+  /// Starts a new frame, keeping the storage of the last one.
+  mutating func removeAll() {
+    instances.removeAll(keepingCapacity: true)
+    draws.removeAll(keepingCapacity: true)
+    glyphRunHits = 0
+    glyphRunMisses = 0
+  }
+
+  mutating func append(_ quad: RenderableQuad, texture: GLuint) {
+    instances.append(QuadInstance(quad))
+    extend(texture, by: 1)
+  }
+
+  /// Appends the background of `text` followed by one instance per glyph, all
+  /// from one atlas page. Runs of texts drawn before are copied from the cache.
+  mutating func append(_ text: RenderableText, texture: GLuint) {
+    let start = instances.count
+    if text.text.utf8.count > GlyphRunCache.maxLength {
+      Self.layOut(text, at: text.pos, into: &instances)
+    } else {
+      let key = GlyphRunCache.Key(
+        text: text.text, scale: text.scale, foreground: RGBA8(text.foreground), background: RGBA8(text.background))
+      let run: [QuadInstance]
+      if let cached = glyphRuns.run(for: key) {
+        glyphRunHits += 1
+        run = cached
+      } else {
+        glyphRunMisses += 1
+        var laidOut: [QuadInstance] = []
+        Self.layOut(text, at: (0, 0), into: &laidOut)
+        glyphRuns.insert(laidOut, for: key)
+        run = laidOut
+      }
+      let x = UInt16(clamping: text.pos.x)
+      let y = UInt16(clamping: text.pos.y)
+      instances.reserveCapacity(instances.count + run.count)
+      for instance in run {
+        instances.append(instance.moved(x: x, y: y))
+      }
+    }
+    extend(texture, by: instances.count - start)
+  }
+
+  /// Appends the background and glyphs of `text` as if it started at `origin`.
+  ///
+  /// Colors and rows are packed once for the whole run. The array grows once,
+  /// then sixteen glyphs at a time are looked up from sixteen bytes loaded
+  /// together and written in place with their columns, which are computed
+  /// together too. Coordinates past the largest one are clamped the same way
+  /// as for a single glyph.
+  static func layOut(_ text: RenderableText, at origin: (x: UInt, y: UInt), into instances: inout [QuadInstance]) {
+    let limit = UInt(UInt16.max) + 1
+    let advance = min((Wayland.glyphW + Wayland.glyphSpacing) * text.scale, limit)
+    let w = min(Wayland.glyphW * text.scale, limit)
+    let utf8 = text.text.utf8
+    let bytes = utf8.span
+    let count = bytes.count
+    let totalWidth = count == 0 ? 0 : UInt(count) * advance - min(Wayland.glyphSpacing * text.scale, advance)
+    let y0 = UInt16(clamping: origin.y)
+    let y1 = UInt16(clamping: origin.y + Wayland.glyphH * text.scale)
+    let foreground = RGBA8(text.foreground)
+
+    instances.reserveCapacity(instances.count + 1 + count)
+    instances.append(
+      QuadInstance(
+        dst_p0: (UInt16(clamping: origin.x), y0),
+        dst_p1: (UInt16(clamping: origin.x + totalWidth), y1),
+        color: RGBA8(text.background)
+      ))
+    // Rows and colors are the same for every glyph, only columns and glyphs are written below.
+    let glyph = QuadInstance(dst_p0: (0, y0), dst_p1: (0, y1), glyph: 0, color: foreground)
+    let first = instances.count
+    instances.append(contentsOf: repeatElement(glyph, count: count))
+
+    // Every operand stays below 2^16 * 17, so the lanes never overflow.
+    let lanes = SIMD16<UInt32>(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15) &* UInt32(advance)
+    let largest = SIMD16<UInt32>(repeating: UInt32(UInt16.max))
+    let table = Wayland.glyphTable
+    var penX = origin.x
+    unsafe bytes.withUnsafeBufferPointer { bytes in
+      unsafe instances.withUnsafeMutableBufferPointer { instances in
+        var start = 0
+        while start < count {
+          let width = min(16, count - start)
+          // Lanes past the end of the text stay 0 and are not written.
+          var codes = SIMD16<UInt8>()
+          if width == 16 {
+            codes = unsafe UnsafeRawPointer(bytes.baseAddress! + start).loadUnaligned(as: SIMD16<UInt8>.self)
+          } else {
+            for lane in 0..<width {
+              codes[lane] = unsafe bytes[start + lane]
+            }
+          }
+          var glyphs = SIMD16<UInt16>()
+          for lane in 0..<16 {
+            glyphs[lane] = table[Int(codes[lane])]
+          }
+
+          let x0 = SIMD16<UInt32>(repeating: UInt32(min(penX, limit))) &+ lanes
+          let left = SIMD16<UInt16>(truncatingIfNeeded: x0.replacing(with: largest, where: x0 .> largest))
+          let x1 = x0 &+ UInt32(w)
+          let right = SIMD16<UInt16>(truncatingIfNeeded: x1.replacing(with: largest, where: x1 .> largest))
+          for lane in 0..<width {
+            let index = first + start + lane
+            unsafe instances[index].dst_p0.0 = left[lane]
+            unsafe instances[index].dst_p1.0 = right[lane]
+            unsafe instances[index].glyph = glyphs[lane]
+          }
+          penX += 16 * advance
+          start += 16
+        }
+      }
+    }
+  }
+
+  private mutating func extend(_ texture: GLuint, by count: Int) {
+    if let last = draws.last, last.texture == texture {
+      draws[draws.count - 1].count += count
+    } else {
+      draws.append(Draw(texture: texture, first: instances.count - count, count: count))
+    }
+  }
+}
+
+extension Wayland {
+  /// Lays out `text` the way ``drawText(_:)`` does on a cache miss and
+  /// returns the number of instances, so glyph generation can be timed.
+  @_spi(Benchmarks)
+  public static func layOutText(_ text: String, scale: UInt = 1) -> Int {
+    var instances: [QuadInstance] = []
+    FrameBatch.layOut(RenderableText(text, at: (0, 0), scale: scale), at: (0, 0), into: &instances)
+    return instances.count
+  }
+}
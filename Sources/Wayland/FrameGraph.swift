@@ -0,0 +1,41 @@
+import ShapeTree
+
+/// A bar for every sample of a phase, oldest on the left. The budget is half
+/// the height, bars over it are red and longer ones are cut off at the top.
+public struct FrameGraph: Block {
+  let samples: [Duration]
+  let budget: Duration
+  let height: UInt
+  static let barWidth: UInt = 2
+
+  public init(samples: [Duration], budget: Duration, height: UInt = 40) {
+    self.samples = samples
+    self.budget = budget
+    self.height = height
+  }
+
+  /// The graph of `phase` from ``Wayland/profiler`` against the refresh rate.
+  public init(_ phase: FramePhase = .frame, height: UInt = 40) {
+    self.init(samples: Wayland.profiler.samples(phase), budget: Wayland.refresh_rate, height: height)
+  }
+
+  func barHeight(_ sample: Duration) -> UInt {
+    guard budget > .zero else { return height }
+    return UInt(min(sample / budget / 2, 1) * Double(height))
+  }
+
+  public var layer: some Block {
+    Direction(.horizontal) {
+      for sample in samples {
+        Direction(.vertical) {
+          Rect().width(.fixed(Self.barWidth)).height(.grow).background(.black)
+          Rect().width(.fixed(Self.barWidth)).height(.fixed(barHeight(sample)))
+            .background(sample > budget ? .red : .green)
+        }
+        .height(.fixed(height))
+      }
+    }
+    .background(.black)
+    .height(.fixed(height))
+  }
+}
@@ -0,0 +1,56 @@
+/// Decides when the event loop hands out a `.frame`.
+///
+/// A frame is only sent when there is work for it: an invalidation, input or
+/// a configure since the last frame started drawing, or always when
+/// ``continuous`` is set.
+///
+/// A committed frame asks the compositor for a `wl_surface.frame` callback,
+/// and the next frame waits for it, so a hidden surface gets no frames and
+/// drawing follows the compositor's repaint cycle. The refresh timer only
+/// starts frames while no callback is outstanding, before the first commit or
+/// after a frame that committed nothing. Either way a frame is never sent
+/// while the last one has not started drawing.
+struct FramePacer {
+  /// Sends frames without waiting for an invalidation.
+  var continuous = false
+  /// A callback was requested and the compositor has not answered it yet.
+  private(set) var awaitingCallback = false
+  /// A `.frame` was sent and drawing it has not started.
+  private(set) var framePending = false
+  /// Something changed since the last frame started drawing.
+  private(set) var invalidated = false
+
+  /// Something needs a frame, returns whether to send one right away.
+  mutating func invalidate() -> Bool {
+    invalidated = true
+    return awaitingCallback ? false : schedule()
+  }
+
+  /// A commit asked for a callback.
+  mutating func committed() {
+    awaitingCallback = true
+  }
+
+  /// The compositor is ready for the next frame, returns whether to send one.
+  mutating func callbackDone() -> Bool {
+    awaitingCallback = false
+    return schedule()
+  }
+
+  /// The refresh timer fired, returns whether to send a frame.
+  mutating func timerFired() -> Bool {
+    awaitingCallback ? false : schedule()
+  }
+
+  /// The frame sent starts drawing, and takes every invalidation so far with it.
+  mutating func frameStarted() {
+    framePending = false
+    invalidated = false
+  }
+
+  private mutating func schedule() -> Bool {
+    guard !framePending, invalidated || continuous else { return false }
+    framePending = true
+    return true
+  }
+}
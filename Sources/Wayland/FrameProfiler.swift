@@ -0,0 +1,83 @@
+/// A part of a frame ``FrameProfiler`` times.
+public enum FramePhase: Int, CaseIterable, Sendable {
+  /// The layout pass collecting attributes and intrinsic sizes.
+  case measure
+  /// The layout pass growing and positioning.
+  case place
+  /// The attributes walker of ``measure`` run on its own, this and the next
+  /// three only while ``Wayland/profilesLayoutWalkers`` is set.
+  case attributes
+  /// The size walker of ``measure`` run on its own.
+  case size
+  /// The grow walker of ``place`` run on its own.
+  case grow
+  /// The position walker of ``place`` run on its own.
+  case position
+  /// Walking the layout into draw calls, quads and glyph runs.
+  case render
+  /// Copying the frame's instances into the stream buffer.
+  case upload
+  /// Drawing the damage of the software backend's canvas.
+  case rasterize
+  /// Handing the frame to the compositor.
+  case present
+  /// GPU time of the frame, from `EXT_disjoint_timer_query`.
+  case gpu
+  /// `preDraw` to `postDraw`.
+  case frame
+}
+
+/// How long a phase took over the samples kept.
+public struct PhaseStats: Equatable, Sendable {
+  public let samples: Int
+  public let min: Duration
+  public let average: Duration
+  /// Slower than 99% of the samples, the slowest with fewer than a hundred.
+  public let p99: Duration
+}
+
+/// The last ``capacity`` samples of every ``FramePhase``, in a ring per phase.
+///
+/// Only the phases a frame went through are recorded, a frame that did not
+/// change has a `measure` and `place` sample but no `upload`.
+public struct FrameProfiler: Sendable {
+  public static let capacity = 128
+
+  private var samples: [Duration]
+  private var counts: [Int]
+
+  public init() {
+    samples = Array(repeating: .zero, count: Self.capacity * FramePhase.allCases.count)
+    counts = Array(repeating: 0, count: FramePhase.allCases.count)
+  }
+
+  mutating func record(_ phase: FramePhase, _ duration: Duration) {
+    samples[phase.rawValue * Self.capacity + counts[phase.rawValue] % Self.capacity] = duration
+    counts[phase.rawValue] += 1
+  }
+
+  /// The samples kept of `phase`, oldest first.
+  public func samples(_ phase: FramePhase) -> [Duration] {
+    let count = counts[phase.rawValue]
+    let ring = samples[phase.rawValue * Self.capacity..<(phase.rawValue + 1) * Self.capacity]
+    guard count > Self.capacity else { return Array(ring.prefix(count)) }
+    let split = ring.startIndex + count % Self.capacity
+    return Array(ring[split...] + ring[..<split])
+  }
+
+  /// `nil` until `phase` was recorded.
+  public func stats(_ phase: FramePhase) -> PhaseStats? {
+    let sorted = samples(phase).sorted()
+    guard let first = sorted.first else { return nil }
+    let total = sorted.reduce(Duration.zero, +)
+    return PhaseStats(
+      samples: sorted.count,
+      min: first,
+      average: total / sorted.count,
+      p99: sorted[(sorted.count * 99 - 1) / 100])
+  }
+
+  public mutating func removeAll() {
+    counts = Array(repeating: 0, count: FramePhase.allCases.count)
+  }
+}
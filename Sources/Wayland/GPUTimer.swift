@@ -0,0 +1,63 @@
+import CGLES3
+
+/// Times frames on the GPU with `EXT_disjoint_timer_query`.
+///
+/// Results are collected a few frames later once they are available, so the
+/// CPU never waits on a query. Only the 32-bit result of core ES 3 is read,
+/// which holds a little over four seconds of nanoseconds.
+struct GPUTimer {
+  // From gl2ext.h, which CGLES3 does not include.
+  static let timeElapsed = GLenum(0x88BF)
+  static let gpuDisjoint = GLenum(0x8FBB)
+  /// Frames whose results may be outstanding before timing is skipped.
+  static let maxPending = 4
+
+  private var free: [GLuint] = []
+  private var pending: [GLuint] = []
+  private var running: GLuint? = nil
+
+  /// A timer when the context has the extension, `nil` otherwise.
+  static func make() -> GPUTimer? {
+    guard let raw = unsafe glGetString(GLenum(GL_EXTENSIONS)) else { return nil }
+    let extensions = unsafe String(cString: raw)
+    return extensions.contains("GL_EXT_disjoint_timer_query") ? GPUTimer() : nil
+  }
+
+  mutating func begin() {
+    guard running == nil, pending.count < Self.maxPending else { return }
+    var query: GLuint = 0
+    if let reused = free.popLast() {
+      query = reused
+    } else {
+      unsafe glGenQueries(1, &query)
+    }
+    glBeginQuery(Self.timeElapsed, query)
+    running = query
+  }
+
+  mutating func end() {
+    guard let query = running else { return }
+    glEndQuery(Self.timeElapsed)
+    pending.append(query)
+    running = nil
+  }
+
+  /// The times of the frames finished since the last call, oldest first.
+  /// Empty when the GPU was disjoint meanwhile, for example after a clock change.
+  mutating func collect() -> [Duration] {
+    var times: [Duration] = []
+    while let query = pending.first {
+      var available: GLuint = 0
+      unsafe glGetQueryObjectuiv(query, GLenum(GL_QUERY_RESULT_AVAILABLE), &available)
+      guard available != 0 else { break }
+      var nanoseconds: GLuint = 0
+      unsafe glGetQueryObjectuiv(query, GLenum(GL_QUERY_RESULT), &nanoseconds)
+      pending.removeFirst()
+      free.append(query)
+      times.append(.nanoseconds(nanoseconds))
+    }
+    var disjoint: GLint = 0
+    unsafe glGetIntegerv(Self.gpuDisjoint, &disjoint)
+    return disjoint == 0 ? times : []
+  }
+}
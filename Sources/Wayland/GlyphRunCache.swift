@@ -0,0 +1,92 @@
+/// The instances of recently drawn texts, laid out at the origin.
+///
+/// Most texts are drawn again the next frame, often somewhere else, so a hit
+/// only moves the cached run to where the text starts. Least recently used runs
+/// are dropped once the cache holds ``capacity`` of them.
+struct GlyphRunCache {
+  struct Key: Hashable {
+    let text: String
+    let scale: UInt
+    let foreground: RGBA8
+    let background: RGBA8
+  }
+
+  /// Longer texts are not cached, they would push out many short ones for a single hit.
+  static var maxLength: Int { 1024 }
+
+  let capacity: Int
+  private var slots: [Key: Int] = [:]
+  private var keys: [Key] = []
+  private var runs: [[QuadInstance]] = []
+  // A list through the slots from most to least recently used.
+  private var newer: [Int] = []
+  private var older: [Int] = []
+  private var newest = -1
+  private var oldest = -1
+
+  init(capacity: Int = 256) {
+    precondition(capacity > 0, "A glyph run cache needs room for at least one run")
+    self.capacity = capacity
+  }
+
+  var count: Int { slots.count }
+
+  /// The run of `key`, which becomes the most recently used.
+  mutating func run(for key: Key) -> [QuadInstance]? {
+    guard let slot = slots[key] else { return nil }
+    unlink(slot)
+    link(slot)
+    return runs[slot]
+  }
+
+  /// Remembers `run` for `key`, dropping the least recently used run when full.
+  mutating func insert(_ run: [QuadInstance], for key: Key) {
+    if let slot = slots[key] {
+      runs[slot] = run
+      unlink(slot)
+      link(slot)
+      return
+    }
+    let slot: Int
+    if slots.count < capacity {
+      slot = keys.count
+      keys.append(key)
+      runs.append(run)
+      newer.append(-1)
+      older.append(-1)
+    } else {
+      slot = oldest
+      unlink(slot)
+      slots[keys[slot]] = nil
+      keys[slot] = key
+      runs[slot] = run
+    }
+    slots[key] = slot
+    link(slot)
+  }
+
+  private mutating func link(_ slot: Int) {
+    newer[slot] = -1
+    older[slot] = newest
+    if newest >= 0 {
+      newer[newest] = slot
+    }
+    newest = slot
+    if oldest < 0 {
+      oldest = slot
+    }
+  }
+
+  private mutating func unlink(_ slot: Int) {
+    if newer[slot] >= 0 {
+      older[newer[slot]] = older[slot]
+    } else {
+      newest = older[slot]
+    }
+    if older[slot] >= 0 {
+      newer[older[slot]] = newer[slot]
+    } else {
+      oldest = newer[slot]
+    }
+  }
+}
@@ -0,0 +1,47 @@
+import Foundation
+
+/// An image with 8 bits per RGBA channel, rows from the top.
+public struct Pixels: Equatable, Sendable {
+  public let width: Int
+  public let height: Int
+  public var rgba: [UInt8]
+
+  public init(width: Int, height: Int, rgba: [UInt8]) {
+    precondition(rgba.count == width * height * 4, "\(rgba.count) bytes for a \(width)×\(height) image")
+    self.width = width
+    self.height = height
+    self.rgba = rgba
+  }
+
+  public func pixel(x: Int, y: Int) -> (r: UInt8, g: UInt8, b: UInt8, a: UInt8) {
+    let idx = (y * width + x) * 4
+    return (rgba[idx], rgba[idx + 1], rgba[idx + 2], rgba[idx + 3])
+  }
+
+  /// How many pixels have a color channel more than `tolerance` away from the
+  /// same pixel of `other`, ignoring alpha.
+  public func countDifferences(from other: Pixels, tolerance: UInt8 = 0) -> Int {
+    precondition(width == other.width && height == other.height, "Comparing images of different sizes")
+    return stride(from: 0, to: rgba.count, by: 4).count { idx in
+      (0..<3).contains { channel in
+        let a = rgba[idx + channel]
+        let b = other.rgba[idx + channel]
+        return max(a, b) - min(a, b) > tolerance
+      }
+    }
+  }
+
+  /// The image as a binary PPM, without alpha.
+  public func ppm() -> [UInt8] {
+    var bytes = Array("P6\n\(width) \(height)\n255\n".utf8)
+    bytes.reserveCapacity(bytes.count + width * height * 3)
+    for idx in stride(from: 0, to: rgba.count, by: 4) {
+      bytes.append(contentsOf: rgba[idx..<idx + 3])
+    }
+    return bytes
+  }
+
+  public func write(ppm path: String) throws {
+    try Data(ppm()).write(to: URL(fileURLWithPath: path))
+  }
+}
@@ -0,0 +1,92 @@
+/// A color with 8 bits per channel, the way the vertex shader reads it.
+struct RGBA8: BitwiseCopyable, Hashable {
+  var r, g, b, a: UInt8
+
+  init(r: UInt8, g: UInt8, b: UInt8, a: UInt8) {
+    self.r = r
+    self.g = g
+    self.b = b
+    self.a = a
+  }
+
+  init(_ rgb: RGB) {
+    func channel(_ value: Float) -> UInt8 {
+      UInt8((min(max(value, 0), 1) * 255).rounded())
+    }
+    self.init(r: channel(rgb.r), g: channel(rgb.g), b: channel(rgb.b), a: channel(rgb.a))
+  }
+}
+
+/// One quad or glyph in the instance buffer, 20 bytes instead of the 72 of a
+/// ``RenderableQuad``.
+///
+/// Rectangles are whole pixels and glyphs are an index into the font atlas,
+/// the vertex shader turns them back into positions and texture coordinates.
+struct QuadInstance: BitwiseCopyable {
+  /// The glyph of quads without one, they sample the white block of the atlas page.
+  static let plain = UInt16.max
+
+  var dst_p0: (UInt16, UInt16)
+  var dst_p1: (UInt16, UInt16)
+  var color: RGBA8
+  var borderColor: RGBA8
+  var glyph: UInt16
+  var borderWidth: UInt8
+  var cornerRadius: UInt8
+
+  init(
+    dst_p0: (UInt16, UInt16), dst_p1: (UInt16, UInt16), glyph: UInt16 = Self.plain, color: RGBA8,
+    borderColor: RGBA8 = RGBA8(r: 0, g: 0, b: 0, a: 0), borderWidth: UInt8 = 0, cornerRadius: UInt8 = 0
+  ) {
+    self.dst_p0 = dst_p0
+    self.dst_p1 = dst_p1
+    self.color = color
+    self.borderColor = borderColor
+    self.glyph = glyph
+    self.borderWidth = borderWidth
+    self.cornerRadius = cornerRadius
+  }
+
+  /// Packs a plain quad, clamping what does not fit.
+  init(_ quad: RenderableQuad) {
+    func pixel(_ value: Float) -> UInt16 {
+      UInt16(min(max(value, 0), Float(UInt16.max)))
+    }
+    func byte(_ value: Float) -> UInt8 {
+      UInt8(min(max(value, 0), Float(UInt8.max)))
+    }
+    self.init(
+      dst_p0: (pixel(quad.dst_p0.0), pixel(quad.dst_p0.1)),
+      dst_p1: (pixel(quad.dst_p1.0), pixel(quad.dst_p1.1)),
+      color: RGBA8(quad.color),
+      borderColor: RGBA8(quad.borderColor),
+      borderWidth: byte(quad.borderWidth),
+      cornerRadius: byte(quad.cornerRadius)
+    )
+  }
+}
+
+extension QuadInstance {
+  /// The instance moved right by `x` and down by `y`, clamped to the largest coordinate.
+  func moved(x: UInt16, y: UInt16) -> QuadInstance {
+    var moved = self
+    moved.dst_p0 = (dst_p0.0.addingClamped(x), dst_p0.1.addingClamped(y))
+    moved.dst_p1 = (dst_p1.0.addingClamped(x), dst_p1.1.addingClamped(y))
+    return moved
+  }
+}
+
+extension UInt16 {
+  fileprivate func addingClamped(_ other: UInt16) -> UInt16 {
+    let (sum, overflow) = addingReportingOverflow(other)
+    return overflow ? .max : sum
+  }
+}
+
+extension QuadInstance: Equatable {
+  static func == (lhs: QuadInstance, rhs: QuadInstance) -> Bool {
+    lhs.dst_p0 == rhs.dst_p0 && lhs.dst_p1 == rhs.dst_p1 && lhs.glyph == rhs.glyph
+      && lhs.color == rhs.color && lhs.borderColor == rhs.borderColor
+      && lhs.borderWidth == rhs.borderWidth && lhs.cornerRadius == rhs.cornerRadius
+  }
+}
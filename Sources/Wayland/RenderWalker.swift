@@ -1,92 +1,236 @@
+import CGLES3
 import Logging
-import ShapeTree
+@_spi(Benchmarks) import ShapeTree
 
 @MainActor
 extension Wayland {
+  /// Carries layout between frames so ``render(_:logLevel:)`` only lays out what changed.
+  static let layoutCache = LayoutCache()
+
   static func renderLayout(
-    _ block: some Block, layout: Layout, settings: FontMetrics, logLevel: Logger.Level = .warning
+    _ block: some Block, layout: Layout, settings: some FontMetrics, to drawer: any Renderer.Type = Wayland.self,
+    logLevel: Logger.Level = .warning
   ) {
     var renderer = RenderWalker(
       settings: settings,
       positions: layout.positions,
       sizes: layout.sizes,
-      Self.self,
+      ids: layout.nodes.ids,
+      drawer,
       logLevel: logLevel
     )
+    let start = ContinuousClock.now
     block.walk(with: &renderer)
+    profiler.record(.render, ContinuousClock.now - start)
+  }
+
+  /// Renders `block` into ``FrameRecorder`` instead of the GPU and returns the
+  /// number of draw calls, so rendering can be timed without a display.
+  @_spi(Benchmarks)
+  public static func recordFrame(_ block: some Block, layout: Layout, settings: some FontMetrics) -> Int {
+    FrameRecorder.commands.removeAll(keepingCapacity: true)
+    renderLayout(block, layout: layout, settings: settings, to: FrameRecorder.self)
+    return FrameRecorder.commands.count
   }
 
   static func calculateLayout(
     _ block: some Block,
     height: UInt = Wayland.windowHeight,
     width: UInt = Wayland.windowWidth,
-    settings: FontMetrics
+    settings: some FontMetrics,
+    cache: LayoutCache? = nil
   ) -> Layout {
-    return ShapeTree.calculateLayout(block, height: height, width: width, settings: settings)
+    let layout = ShapeTree.calculateLayout(
+      block, height: height, width: width, settings: settings, cache: cache
+    ) { pass, duration in
+      profiler.record(pass == .measure ? .measure : .place, duration)
+    }
+    if profilesLayoutWalkers {
+      profileLayoutWalkers(block, height: height, width: width, settings: settings)
+    }
+    return layout
+  }
+
+  /// Times each walker the fused passes run, the same way the benchmarks do.
+  private static func profileLayoutWalkers(
+    _ block: some Block, height: UInt, width: UInt, settings: some FontMetrics
+  ) {
+    let phases = LayoutPhases(block, height: height, width: width, settings: settings)
+    func time(_ phase: FramePhase, _ walk: () -> Int) {
+      let start = ContinuousClock.now
+      _ = walk()
+      profiler.record(phase, ContinuousClock.now - start)
+    }
+    time(.attributes) { phases.walkAttributes() }
+    time(.size) { phases.walkSizes() }
+    time(.grow) { phases.walkGrow() }
+    time(.position) { phases.walkPositions() }
   }
 
   public static func render(
     _ block: some Block,
     logLevel: Logger.Level = .warning
   ) {
-    let layout = calculateLayout(block, settings: Wayland.fontSettings)
-    renderLayout(block, layout: layout, settings: Wayland.fontSettings, logLevel: logLevel)
+    let layout = calculateLayout(block, settings: Wayland.fontSettings, cache: layoutCache)
+    guard backend == .gl else {
+      renderSoftware(block, layout: layout, logLevel: logLevel)
+      return
+    }
+    guard skipsUnchangedFrames else {
+      retainedFrame.invalidate()
+      damageHistory.record([DamageRect(x: 0, y: 0, width: windowWidth, height: windowHeight)])
+      frameDamage = nil
+      beginFrame()
+      renderLayout(block, layout: layout, settings: Wayland.fontSettings, logLevel: logLevel)
+      uploadBatch()
+      drawBatch()
+      return
+    }
+
+    FrameRecorder.commands.removeAll(keepingCapacity: true)
+    renderLayout(block, layout: layout, settings: Wayland.fontSettings, to: FrameRecorder.self, logLevel: logLevel)
+    guard retainedFrame.update(&FrameRecorder.commands, width: windowWidth, height: windowHeight) else {
+      skippedFrames += 1
+      return
+    }
+    damageHistory.record(retainedFrame.damage)
+    frameDamage = retainedFrame.damage
+
+    // The back buffer still holds an older frame, so everything that changed
+    // since then is redrawn with the rest of the buffer left as it is.
+    guard let repaint = damageHistory.repaint(age: bufferAge()) else {
+      beginFrame()
+      batchRetainedFrame()
+      drawBatch()
+      return
+    }
+    beginFrame(clear: false)
+    // Uploaded once and drawn again into every damaged rectangle.
+    batchRetainedFrame()
+    glEnable(GLenum(GL_SCISSOR_TEST))
+    let window = DamageRect(x: 0, y: 0, width: windowWidth, height: windowHeight)
+    // Older damage may be from before a resize.
+    for rect in repaint.compactMap({ $0.intersection(window) }) {
+      glScissor(
+        GLint(rect.x), GLint(windowHeight - rect.y - rect.height), GLsizei(rect.width), GLsizei(rect.height))
+      glClear(GLbitfield(GL_COLOR_BUFFER_BIT))
+      drawBatch()
+    }
+    glDisable(GLenum(GL_SCISSOR_TEST))
+  }
+
+  /// Draws into ``SoftwareRenderer/canvas``, which holds an older frame, so
+  /// only what changed since then is drawn again.
+  private static func renderSoftware(_ block: some Block, layout: Layout, logLevel: Logger.Level) {
+    guard skipsUnchangedFrames else {
+      retainedFrame.invalidate()
+      damageHistory.record([DamageRect(x: 0, y: 0, width: windowWidth, height: windowHeight)])
+      frameDamage = nil
+      guard beginSoftwareFrame() != nil else { return }
+      frameDrawn = true
+      frameStats = FrameStats()
+      SoftwareRenderer.canvas.clear()
+      renderLayout(block, layout: layout, settings: Wayland.fontSettings, to: SoftwareRenderer.self, logLevel: logLevel)
+      return
+    }
+
+    FrameRecorder.commands.removeAll(keepingCapacity: true)
+    renderLayout(block, layout: layout, settings: Wayland.fontSettings, to: FrameRecorder.self, logLevel: logLevel)
+    guard retainedFrame.update(&FrameRecorder.commands, width: windowWidth, height: windowHeight) else {
+      skippedFrames += 1
+      return
+    }
+    damageHistory.record(retainedFrame.damage)
+    frameDamage = retainedFrame.damage
+    guard let age = beginSoftwareFrame() else { return }
+    frameDrawn = true
+    frameStats = FrameStats()
+    let rasterizeStart = ContinuousClock.now
+    defer { profiler.record(.rasterize, ContinuousClock.now - rasterizeStart) }
+    let window = DamageRect(x: 0, y: 0, width: windowWidth, height: windowHeight)
+    // Older damage may be from before a resize.
+    for rect in (damageHistory.repaint(age: age) ?? [window]).compactMap({ $0.intersection(window) }) {
+      SoftwareRenderer.canvas.clip = rect
+      SoftwareRenderer.canvas.clear()
+      for command in retainedFrame.commands {
+        switch command {
+        case .quad(let quad):
+          SoftwareRenderer.drawQuad(quad)
+        case .text(let text):
+          SoftwareRenderer.drawText(text)
+        }
+      }
+    }
+    SoftwareRenderer.canvas.clip = nil
+  }
+
+  private static func batchRetainedFrame() {
+    for command in retainedFrame.commands {
+      switch command {
+      case .quad(let quad):
+        drawQuad(quad)
+      case .text(let text):
+        drawText(text)
+      }
+    }
+    uploadBatch()
   }
 }
 
 struct RenderWalker: Walker {
   var currentId: Hash = 0
   var parentId: Hash = 0
+  var currentIndex: NodeIndex = NodeTable.none
+  var parentIndex: NodeIndex = NodeTable.none
+  var nextIndex: NodeIndex = 0
   let logger: Logger
-  private var positions: [Hash: (x: UInt, y: UInt)] = [:]
-  private var sizes: [Hash: Container]
+  private let positions: NodeColumn<Position>
+  private let sizes: NodeColumn<Container>
+  // IDs from the layout, empty when the walk computes its own.
+  private let ids: NodeColumn<Hash>
   private let drawer: Renderer.Type
-  private let settings: FontMetrics
+  // The only metric rendering needs, read once instead of through the metrics on every text.
+  private let defaultScale: UInt
 
   init(
-    settings: FontMetrics,
-    positions: [Hash: (x: UInt, y: UInt)],
-    sizes: [Hash: Container],
+    settings: some FontMetrics,
+    positions: NodeColumn<Position>,
+    sizes: NodeColumn<Container>,
+    ids: NodeColumn<Hash> = NodeColumn(),
     _ drawer: any Renderer.Type,
     logLevel: Logger.Level
   ) {
-    self.settings = settings
+    self.defaultScale = settings.scale
     self.positions = positions
     self.sizes = sizes
+    self.ids = ids
     self.drawer = drawer
     self.logger = Logger.create(logLevel: logLevel)
   }
 
   mutating func before(_ block: some Block) {
-    guard let pos = positions[currentId] else {
-      logger.warning("No position for \(currentId)")
+    guard currentIndex < positions.endIndex else {
+      logger.warning("No position for \(currentIndex)")
       return
     }
+    let pos = positions[currentIndex]
 
-    if let attributedBlock = block as? any HasAttributes,
-      let word = attributedBlock.layer as? Text
-    {
-      let scale = attributedBlock.attributes.scale ?? settings.scale
-      let foreground = attributedBlock.attributes.foreground ?? .white
-      let background = attributedBlock.attributes.background ?? .black
-      let padding = attributedBlock.attributes.padding ?? Padding()
+    switch block._kind {
+    case .attributed(let attributes, let word?):
+      let scale = attributes.scale ?? defaultScale
+      let foreground = attributes.foreground ?? .white
+      let background = attributes.background ?? .black
+      let padding = attributes.padding ?? Padding()
       let px = padding.left ?? 0
       let py = padding.top ?? 0
       drawer.drawText(
         word.draw(
           at: (pos.y + py, pos.x + px), scale: scale, foreground: foreground.rgb(), background: background.rgb()))
-      return
-    }
-
-    if let word = block as? Text {
+    case .text(let word):
       drawer.drawText(word.draw(at: (pos.y, pos.x)))
-      return
-    }
-
-    if let attributedBlock = block as? any HasAttributes,
-      let size = sizes[currentId]
-    {
-      let padding = attributedBlock.attributes.padding ?? Padding()
+    case .attributed(let attributes, nil):
+      let size = sizes[currentIndex]
+      let padding = attributes.padding ?? Padding()
       let px = padding.left ?? 0
       let py = padding.top ?? 0
       let quad = RenderableQuad(
@@ -94,16 +238,21 @@ struct RenderWalker: Walker {
         dst_p1: (pos.x + px + size.width, pos.y + py + size.height),
         tex_tl: (0, 0),
         tex_br: (1, 1),
-        color: (attributedBlock.attributes.background ?? Color.white).rgb(),
-        borderColor: (attributedBlock.attributes.borderColor ?? Color.black).rgb(),
-        borderWidth: Float(attributedBlock.attributes.borderWidth ?? 0),
-        cornerRadius: Float(attributedBlock.attributes.borderRadius ?? 0)
+        color: (attributes.background ?? Color.white).rgb(),
+        borderColor: (attributes.borderColor ?? Color.black).rgb(),
+        borderWidth: Float(attributes.borderWidth ?? 0),
+        cornerRadius: Float(attributes.borderRadius ?? 0)
       )
       drawer.drawQuad(quad)
-      return
+    case .composed, .direction, .group:
+      break
     }
   }
 
+  func knownId(at index: NodeIndex) -> Hash? {
+    index < ids.endIndex ? ids[index] : nil
+  }
+
   mutating func after(_ block: some Block) {}
   mutating func before(child block: some Block) {}
   mutating func after(child block: some Block) {}
@@ -40,3 +40,12 @@ struct RenderableQuad: BitwiseCopyable {
     self.cornerRadius = cornerRadius
   }
 }
+
+extension RenderableQuad: Equatable {
+  static func == (lhs: RenderableQuad, rhs: RenderableQuad) -> Bool {
+    lhs.dst_p0 == rhs.dst_p0 && lhs.dst_p1 == rhs.dst_p1
+      && lhs.tex_tl == rhs.tex_tl && lhs.tex_br == rhs.tex_br
+      && lhs.color == rhs.color && lhs.borderColor == rhs.borderColor
+      && lhs.borderWidth == rhs.borderWidth && lhs.cornerRadius == rhs.cornerRadius
+  }
+}
@@ -21,3 +21,10 @@ struct RenderableText {
     self.background = background
   }
 }
+
+extension RenderableText: Equatable {
+  static func == (lhs: RenderableText, rhs: RenderableText) -> Bool {
+    lhs.text == rhs.text && lhs.pos == rhs.pos && lhs.scale == rhs.scale
+      && lhs.foreground == rhs.foreground && lhs.background == rhs.background
+  }
+}
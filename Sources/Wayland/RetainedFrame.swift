@@ -0,0 +1,55 @@
+/// A single draw call recorded from the ``RenderWalker``, in painter's order.
+enum RenderCommand: Equatable {
+  case quad(RenderableQuad)
+  case text(RenderableText)
+}
+
+/// The render output of the last presented frame.
+///
+/// ``Wayland/render(_:logLevel:)`` records a frame before touching the GPU and
+/// only clears, draws and presents the parts that differ from what is on screen.
+@MainActor
+struct RetainedFrame {
+  private(set) var commands: [RenderCommand] = []
+  /// Where the last update differs from the frame before it, clipped to the window.
+  private(set) var damage: [DamageRect] = []
+  private var size: (width: UInt, height: UInt)? = nil
+
+  /// Keeps `commands` if they differ from the retained frame and returns `true`,
+  /// handing the old buffer back through `commands` so it can be reused.
+  mutating func update(_ commands: inout [RenderCommand], width: UInt, height: UInt) -> Bool {
+    let window = DamageRect(x: 0, y: 0, width: width, height: height)
+    if let size, size == (width, height) {
+      let changed = RenderCommand.damage(from: self.commands, to: commands).rects.compactMap {
+        $0.intersection(window)
+      }
+      // Differences that draw nothing visible do not need a frame either.
+      guard !changed.isEmpty else { return false }
+      damage = changed
+    } else {
+      damage = [window]
+    }
+    swap(&self.commands, &commands)
+    size = (width, height)
+    return true
+  }
+
+  /// Forces the next frame to be presented.
+  mutating func invalidate() {
+    size = nil
+  }
+}
+
+/// Records draw calls instead of issuing them.
+@MainActor
+enum FrameRecorder: Renderer {
+  static var commands: [RenderCommand] = []
+
+  static func drawQuad(_ quad: RenderableQuad) {
+    commands.append(.quad(quad))
+  }
+
+  static func drawText(_ text: RenderableText) {
+    commands.append(.text(text))
+  }
+}
@@ -0,0 +1,181 @@
+import Foundation
+
+/// Memory shared with the compositor, created with `memfd_create` and mapped
+/// once. `memory` stays valid until ``destroy()``.
+@safe
+struct ShmPool {
+  let fd: Int32
+  let size: Int
+  let memory: UnsafeMutableRawPointer
+
+  init(size: Int) throws(WaylandError) {
+    let fd = unsafe memfd_create("swift-wayland", UInt32(MFD_CLOEXEC))
+    guard fd >= 0 else { throw WaylandError.error(message: "memfd_create failed") }
+    guard ftruncate(fd, off_t(size)) == 0 else {
+      close(fd)
+      throw WaylandError.error(message: "Could not size a \(size) byte shm pool")
+    }
+    guard let memory = unsafe mmap(nil, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0),
+      unsafe memory != MAP_FAILED
+    else {
+      close(fd)
+      throw WaylandError.error(message: "Could not map a \(size) byte shm pool")
+    }
+    self.fd = fd
+    self.size = size
+    unsafe self.memory = memory
+  }
+
+  /// Unmaps the pool, the compositor keeps its own mapping until it is done with the buffers.
+  func destroy() {
+    _ = unsafe munmap(memory, size)
+    close(fd)
+  }
+}
+
+/// Buffers of one pool handed to the compositor in turn.
+///
+/// A buffer is drawn into again only once the compositor released it. Its age,
+/// the frames since it was last drawn, tells how much of ``DamageHistory`` it
+/// is missing, the same as `EGL_EXT_buffer_age` does for the GL path.
+struct ShmSwapchain<Buffer: Equatable> {
+  static var maxBuffers: Int { 3 }
+
+  struct Slot {
+    let buffer: Buffer
+    var busy = false
+    /// The frame last drawn into it, `nil` while it holds nothing.
+    var frame: Int? = nil
+  }
+
+  private(set) var slots: [Slot] = []
+  /// Frames acquired so far, whether or not a buffer was free for them.
+  private(set) var frame = 0
+  private var presentedFrame: Int? = nil
+
+  /// Whether ``add(_:)`` should make another buffer, all of them being busy.
+  var needsBuffer: Bool {
+    slots.count < Self.maxBuffers && !slots.contains { !$0.busy }
+  }
+
+  mutating func add(_ buffer: Buffer) {
+    slots.append(Slot(buffer: buffer))
+  }
+
+  /// Starts the next frame and returns a released buffer for it, with its age
+  /// or `0` when it has never been drawn. `nil` when the compositor holds them all.
+  mutating func acquire() -> (index: Int, age: Int)? {
+    frame += 1
+    // The least recently drawn, giving the compositor longest to release the others.
+    let free = slots.indices.filter { !slots[$0].busy }
+    guard let index = free.min(by: { (slots[$0].frame ?? 0) < (slots[$1].frame ?? 0) }) else { return nil }
+    return (index, slots[index].frame.map { frame - $0 } ?? 0)
+  }
+
+  /// Frames since the last one presented, counting the one being drawn, `0` before the first.
+  var presentedAge: Int {
+    presentedFrame.map { frame - $0 } ?? 0
+  }
+
+  /// Marks the buffer acquired for this frame as handed to the compositor.
+  mutating func present(_ index: Int) {
+    slots[index].busy = true
+    slots[index].frame = frame
+    presentedFrame = frame
+  }
+
+  mutating func release(_ buffer: Buffer) {
+    guard let index = slots.firstIndex(where: { $0.buffer == buffer }) else { return }
+    slots[index].busy = false
+  }
+
+  /// Forgets every buffer and returns them to be destroyed.
+  mutating func removeAll() -> [Buffer] {
+    defer {
+      slots.removeAll()
+      presentedFrame = nil
+    }
+    return slots.map(\.buffer)
+  }
+}
+
+/// What presenting needs from the compositor, `wl_shm` for windows and a stand-in in tests.
+@MainActor
+protocol ShmCompositor {
+  associatedtype Buffer: Equatable
+  /// Shares `pool` with the compositor, the buffers of the one before are destroyed already.
+  mutating func share(_ pool: ShmPool)
+  mutating func makeBuffer(offset: Int, width: Int, height: Int) -> Buffer
+  mutating func destroy(_ buffer: Buffer)
+  /// Attaches and commits `buffer`, `damage` is `nil` when all of it changed.
+  mutating func attach(_ buffer: Buffer, damage: [DamageRect]?)
+}
+
+/// Presents software frames through ``ShmSwapchain`` buffers of an XRGB8888
+/// ``ShmPool``. A frame is drawn straight into the buffer it is presented in,
+/// redrawing only what that buffer is missing, nothing is copied.
+@MainActor
+struct ShmPresenter<Compositor: ShmCompositor> {
+  var compositor: Compositor
+  private(set) var pool: ShmPool? = nil
+  private(set) var swapchain = ShmSwapchain<Compositor.Buffer>()
+  private(set) var width = 0
+  private(set) var height = 0
+  /// The buffer drawn into since ``acquire(width:height:)``.
+  private(set) var acquired: Int? = nil
+
+  init(compositor: Compositor) {
+    self.compositor = compositor
+  }
+
+  /// Starts a frame in a released buffer of the size given and returns its
+  /// pixels and age, `nil` when every buffer is still with the compositor.
+  /// The pixels stay mapped until the size changes.
+  mutating func acquire(
+    width: Int, height: Int
+  ) throws(WaylandError) -> (pixels: UnsafeMutableBufferPointer<UInt32>, age: Int)? {
+    if width != self.width || height != self.height {
+      try reallocate(width: width, height: height)
+    }
+    guard let pool, width > 0, height > 0 else { return nil }
+    let bufferSize = width * height * 4
+    if swapchain.needsBuffer {
+      swapchain.add(
+        compositor.makeBuffer(offset: swapchain.slots.count * bufferSize, width: width, height: height))
+    }
+    guard let next = swapchain.acquire() else { return nil }
+    acquired = next.index
+    let start = unsafe (pool.memory + next.index * bufferSize).bindMemory(to: UInt32.self, capacity: width * height)
+    return unsafe (UnsafeMutableBufferPointer(start: start, count: width * height), next.age)
+  }
+
+  /// Attaches the buffer acquired for this frame, `false` when there is none.
+  /// `history` has to hold the damage of every frame acquired for, newest first.
+  mutating func present(history: DamageHistory) -> Bool {
+    guard let index = acquired else { return false }
+    acquired = nil
+    compositor.attach(swapchain.slots[index].buffer, damage: history.repaint(age: swapchain.presentedAge))
+    swapchain.present(index)
+    return true
+  }
+
+  mutating func release(_ buffer: Compositor.Buffer) {
+    swapchain.release(buffer)
+  }
+
+  /// Replaces the pool with one for ``ShmSwapchain/maxBuffers`` buffers of the new size.
+  private mutating func reallocate(width: Int, height: Int) throws(WaylandError) {
+    for buffer in swapchain.removeAll() {
+      compositor.destroy(buffer)
+    }
+    pool?.destroy()
+    pool = nil
+    acquired = nil
+    self.width = width
+    self.height = height
+    guard width > 0, height > 0 else { return }
+    let pool = try ShmPool(size: width * height * 4 * ShmSwapchain<Compositor.Buffer>.maxBuffers)
+    compositor.share(pool)
+    self.pool = pool
+  }
+}
@@ -0,0 +1,277 @@
+/// Draws quads and text into ARGB8888 pixels on the CPU, the way the GL
+/// program draws them: colors blended over what is there, borders and
+/// rounded corners as in `fragment.glsl`, and glyphs from the 5×7 font.
+///
+/// Spans of one color are filled eight pixels at a time. Pixels on a rounded
+/// corner are covered by how much of them lies inside the radius, where the
+/// shader only keeps or discards them, so corners differ slightly from GL.
+///
+/// A canvas keeps its own ``pixels``, or draws straight into memory it is
+/// given, a buffer shared with the compositor.
+@MainActor
+@safe
+struct SoftwareCanvas {
+  private(set) var width = 0
+  private(set) var height = 0
+  /// Rows from the top, `0xAARRGGBB`, empty while drawing into memory.
+  private(set) var pixels: [UInt32] = []
+  private var memory: UnsafeMutableBufferPointer<UInt32>? = nil
+  /// Drawing outside of it leaves the pixels alone.
+  var clip: DamageRect? = nil
+
+  /// The rows of every glyph, one bit per column with the leftmost in bit 4.
+  static let glyphRows: [UInt8] = {
+    let font = Wayland.initFont()
+    var rows = [UInt8](repeating: 0, count: Int(Wayland.charCount * Wayland.glyphH))
+    for c in Int(Wayland.firstChar)...Int(Wayland.lastChar) where !font[c].rows[0].isEmpty {
+      for (y, row) in font[c].rows.enumerated() {
+        rows[(c - Int(Wayland.firstChar)) * Int(Wayland.glyphH) + y] = row.utf8.reduce(0) { bits, bit in
+          bits << 1 | (bit == UInt8(ascii: "1") ? 1 : 0)
+        }
+      }
+    }
+    return rows
+  }()
+
+  init(width: UInt = 0, height: UInt = 0) {
+    resize(width: width, height: height)
+  }
+
+  /// Draws into `memory` of `width` × `height` pixels, which has to stay mapped while the canvas draws.
+  @unsafe
+  init(width: UInt, height: UInt, memory: UnsafeMutableBufferPointer<UInt32>) {
+    precondition(memory.count == Int(width * height))
+    self.width = Int(width)
+    self.height = Int(height)
+    unsafe self.memory = memory
+  }
+
+  /// Changes the size, dropping what was drawn when it differs or was drawn into memory.
+  mutating func resize(width: UInt, height: UInt) {
+    guard Int(width) != self.width || Int(height) != self.height || unsafe memory != nil else { return }
+    self.width = Int(width)
+    self.height = Int(height)
+    unsafe memory = nil
+    pixels = [UInt32](repeating: 0xFF00_0000, count: self.width * self.height)
+  }
+
+  /// Fills the clip, or everything without one, with opaque black.
+  mutating func clear() {
+    let area = bounds(x0: 0, y0: 0, x1: width, y1: height)
+    for y in area.rows {
+      fillRow(y, area.columns, color: 0xFF00_0000, alpha: 255)
+    }
+  }
+
+  /// The pixels as RGBA, opaque.
+  func rgbaPixels() -> Pixels {
+    let pixels = unsafe memory.map { unsafe Array($0) } ?? pixels
+    var rgba = [UInt8](repeating: 255, count: pixels.count * 4)
+    for (i, pixel) in pixels.enumerated() {
+      rgba[i * 4] = UInt8(truncatingIfNeeded: pixel >> 16)
+      rgba[i * 4 + 1] = UInt8(truncatingIfNeeded: pixel >> 8)
+      rgba[i * 4 + 2] = UInt8(truncatingIfNeeded: pixel)
+    }
+    return Pixels(width: width, height: height, rgba: rgba)
+  }
+
+  // MARK: - Quads
+
+  mutating func draw(_ quad: RenderableQuad) {
+    let x0 = Int(quad.dst_p0.0)
+    let y0 = Int(quad.dst_p0.1)
+    let w = Int(quad.dst_p1.0) - x0
+    let h = Int(quad.dst_p1.1) - y0
+    let area = bounds(x0: x0, y0: y0, x1: x0 + w, y1: y0 + h)
+    guard !area.rows.isEmpty, !area.columns.isEmpty else { return }
+    let base = Self.argb(quad.color)
+    let baseAlpha = UInt32(base >> 24)
+
+    guard quad.borderWidth > 0, quad.borderColor.a > 0 else {
+      for y in area.rows {
+        fillRow(y, area.columns, color: base, alpha: baseAlpha)
+      }
+      return
+    }
+
+    let border = Self.argb(quad.borderColor)
+    let borderAlpha = UInt32(border >> 24)
+    let bw = quad.borderWidth
+    let radius = quad.cornerRadius
+    let size = (Float(w), Float(h))
+    // Columns this far from either side can be on a border or corner, the rest of a row is one color.
+    let side = Int(max(bw, radius).rounded(.up)) + 1
+    // Narrow or clipped quads have no such columns, every pixel is shaded then.
+    let lower = max(area.columns.lowerBound, x0 + side)
+    let middle = lower..<max(lower, min(area.columns.upperBound, x0 + w - side))
+    for y in area.rows {
+      let py = Float(y - y0) + 0.5
+      if !middle.isEmpty {
+        let isBorder = py < bw || py > size.1 - bw || (radius > 0 && bw > radius)
+        fillRow(y, middle, color: isBorder ? border : base, alpha: isBorder ? borderAlpha : baseAlpha)
+      }
+      for x in area.columns where !middle.contains(x) {
+        let (isBorder, coverage) = Self.shade(Float(x - x0) + 0.5, py, size: size, bw: bw, radius: radius)
+        guard coverage > 0 else { continue }
+        let color = isBorder ? border : base
+        let alpha = UInt32((Float(color >> 24) * coverage).rounded())
+        fillRow(y, x..<x + 1, color: color, alpha: alpha)
+      }
+    }
+  }
+
+  /// Whether a pixel centered at `px`, `py` inside a quad of `size` is on the
+  /// border, and how much of it is inside the quad's rounded corners.
+  static func shade(_ px: Float, _ py: Float, size: (Float, Float), bw: Float, radius: Float) -> (Bool, Float) {
+    let isEdge = px < bw || px > size.0 - bw || py < bw || py > size.1 - bw
+    guard radius > 0 else { return (isEdge, 1) }
+    let cx: Float? =
+      px < radius ? radius : px > size.0 - radius ? size.0 - radius : nil
+    let cy: Float? =
+      py < radius ? radius : py > size.1 - radius ? size.1 - radius : nil
+    // Away from the corners the shader measures a distance of zero, which is
+    // inside the corner border when the border is wider than the radius.
+    guard let cx, let cy else { return (isEdge || bw > radius, 1) }
+    let dist = ((px - cx) * (px - cx) + (py - cy) * (py - cy)).squareRoot()
+    let coverage = min(max(radius - dist + 0.5, 0), 1)
+    return (isEdge || dist > radius - bw, coverage)
+  }
+
+  // MARK: - Text
+
+  mutating func draw(_ text: RenderableText) {
+    let scale = Int(text.scale)
+    let advance = Int(Wayland.glyphW + Wayland.glyphSpacing) * scale
+    let glyphW = Int(Wayland.glyphW)
+    let glyphH = Int(Wayland.glyphH)
+    let count = text.text.utf8.count
+    let x0 = Int(text.pos.x)
+    let y0 = Int(text.pos.y)
+    let totalWidth = count == 0 ? 0 : count * advance - Int(Wayland.glyphSpacing) * scale
+    let background = bounds(x0: x0, y0: y0, x1: x0 + totalWidth, y1: y0 + glyphH * scale)
+    let backgroundColor = Self.argb(text.background)
+    for y in background.rows {
+      fillRow(y, background.columns, color: backgroundColor, alpha: backgroundColor >> 24)
+    }
+
+    let foreground = Self.argb(text.foreground)
+    var penX = x0
+    for c in text.text.utf8 {
+      defer { penX += advance }
+      let glyph = bounds(x0: penX, y0: y0, x1: penX + glyphW * scale, y1: y0 + glyphH * scale)
+      guard !glyph.columns.isEmpty else { continue }
+      let first = Int(Wayland.glyphTable[Int(c)]) * glyphH
+      for y in glyph.rows {
+        let bits = Self.glyphRows[first + (y - y0) / scale]
+        for column in 0..<glyphW where bits & (0x10 >> column) != 0 {
+          let start = penX + column * scale
+          let run = max(start, glyph.columns.lowerBound)..<min(start + scale, glyph.columns.upperBound)
+          if !run.isEmpty {
+            fillRow(y, run, color: foreground, alpha: foreground >> 24)
+          }
+        }
+      }
+    }
+  }
+
+  // MARK: - Pixels
+
+  static func argb(_ color: RGB) -> UInt32 {
+    let rgba = RGBA8(color)
+    return UInt32(rgba.a) << 24 | UInt32(rgba.r) << 16 | UInt32(rgba.g) << 8 | UInt32(rgba.b)
+  }
+
+  /// `x / 255` rounded, exact for every sum of two products of bytes.
+  @inline(__always)
+  static func divide255(_ x: SIMD8<UInt32>) -> SIMD8<UInt32> {
+    let rounded = x &+ 128
+    return (rounded &+ (rounded &>> 8)) &>> 8
+  }
+
+  /// Blends `color` over `columns` of row `y` with `alpha`, opaque spans are
+  /// stored and the rest blended eight pixels at a time.
+  mutating func fillRow(_ y: Int, _ columns: Range<Int>, color: UInt32, alpha: UInt32) {
+    guard alpha > 0 else { return }
+    let start = y * width + columns.lowerBound
+    let end = y * width + columns.upperBound
+    if let memory = unsafe memory {
+      unsafe Self.fill(memory, start..<end, color: color, alpha: alpha)
+    } else {
+      unsafe pixels.withUnsafeMutableBufferPointer { pixels in
+        unsafe Self.fill(pixels, start..<end, color: color, alpha: alpha)
+      }
+    }
+  }
+
+  @inline(__always)
+  private static func fill(
+    _ pixels: UnsafeMutableBufferPointer<UInt32>, _ span: Range<Int>, color: UInt32, alpha: UInt32
+  ) {
+    let start = span.lowerBound
+    let end = span.upperBound
+    if alpha == 255 {
+      unsafe UnsafeMutableBufferPointer(rebasing: pixels[span]).update(repeating: color | 0xFF00_0000)
+      return
+    }
+
+    let source = SIMD8<UInt32>(repeating: color)
+    let alphas = SIMD8<UInt32>(repeating: alpha)
+    let inverse = SIMD8<UInt32>(repeating: 255 - alpha)
+    let mask = SIMD8<UInt32>(repeating: 0xFF)
+    func blend(_ dst: SIMD8<UInt32>) -> SIMD8<UInt32> {
+      func channel(_ shift: UInt32) -> SIMD8<UInt32> {
+        let s = (source &>> shift) & mask
+        let d = (dst &>> shift) & mask
+        return Self.divide255(s &* alphas &+ d &* inverse) &<< shift
+      }
+      return SIMD8<UInt32>(repeating: 0xFF00_0000) | channel(16) | channel(8) | channel(0)
+    }
+    var i = start
+    while i + 8 <= end {
+      let dst = unsafe SIMD8<UInt32>(pixels[i..<i + 8])
+      let out = blend(dst)
+      for lane in 0..<8 {
+        unsafe pixels[i + lane] = out[lane]
+      }
+      i += 8
+    }
+    if i < end {
+      var dst = SIMD8<UInt32>()
+      for lane in 0..<end - i {
+        dst[lane] = unsafe pixels[i + lane]
+      }
+      let out = blend(dst)
+      for lane in 0..<end - i {
+        unsafe pixels[i + lane] = out[lane]
+      }
+    }
+  }
+
+  private func bounds(x0: Int, y0: Int, x1: Int, y1: Int) -> (rows: Range<Int>, columns: Range<Int>) {
+    var left = max(x0, 0)
+    var top = max(y0, 0)
+    var right = min(x1, width)
+    var bottom = min(y1, height)
+    if let clip {
+      left = max(left, Int(clip.x))
+      top = max(top, Int(clip.y))
+      right = min(right, Int(clip.x + clip.width))
+      bottom = min(bottom, Int(clip.y + clip.height))
+    }
+    return (top..<max(top, bottom), left..<max(left, right))
+  }
+}
+
+/// Renders into a ``SoftwareCanvas`` instead of the GPU.
+@MainActor
+enum SoftwareRenderer: Renderer {
+  static var canvas = SoftwareCanvas()
+
+  static func drawQuad(_ quad: RenderableQuad) {
+    canvas.draw(quad)
+  }
+
+  static func drawText(_ text: RenderableText) {
+    canvas.draw(text)
+  }
+}
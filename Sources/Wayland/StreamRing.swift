@@ -0,0 +1,66 @@
+/// Hands out regions of a streaming buffer, one per frame, as a ring.
+///
+/// A region stays reserved until the GPU signals the fence of the frame that
+/// read it, so at least ``framesInFlight`` frames are written without waiting
+/// on the driver. A frame larger than its share of the ring grows the buffer,
+/// which starts over with new storage and forgets the frames in flight.
+/// Sizes and offsets are in instances, which keeps regions aligned to the stride.
+struct StreamRing<Fence> {
+  static var framesInFlight: Int { 3 }
+
+  struct Region: Equatable {
+    let offset: Int
+    let count: Int
+    /// Whether the buffer has to be allocated again with ``StreamRing/capacity`` first.
+    let grew: Bool
+  }
+
+  private(set) var capacity: Int
+  private(set) var head = 0
+  /// Regions the GPU may still be reading, oldest first.
+  private var inFlight: [(range: Range<Int>, fence: Fence)] = []
+  /// The region handed out for the frame being drawn, until it is fenced.
+  private var pending: Range<Int>? = nil
+
+  init(capacity: Int) {
+    self.capacity = capacity
+  }
+
+  var framesPending: Int { inFlight.count }
+
+  /// Reserves room for `count` instances. Calls `wait` for every fence whose
+  /// region the new one overlaps, and `drop` for the fences a grown buffer no
+  /// longer needs, in both cases the caller deletes them afterwards.
+  mutating func reserve(_ count: Int, wait: (Fence) -> Void, drop: (Fence) -> Void) -> Region {
+    if count * Self.framesInFlight > capacity {
+      while count * Self.framesInFlight > capacity {
+        capacity *= 2
+      }
+      for frame in inFlight {
+        drop(frame.fence)
+      }
+      inFlight.removeAll(keepingCapacity: true)
+      head = count
+      pending = 0..<count
+      return Region(offset: 0, count: count, grew: true)
+    }
+
+    let offset = head + count > capacity ? 0 : head
+    let range = offset..<offset + count
+    // Fences signal in order, so the frames before an overlapping one are retired with it.
+    while let oldest = inFlight.first, inFlight.contains(where: { $0.range.overlaps(range) }) {
+      wait(oldest.fence)
+      inFlight.removeFirst()
+    }
+    head = range.upperBound
+    pending = range
+    return Region(offset: offset, count: count, grew: false)
+  }
+
+  /// Fences the region of the frame just drawn, if it reserved one.
+  mutating func commit(_ fence: () -> Fence) {
+    guard let range = pending else { return }
+    inFlight.append((range, fence()))
+    pending = nil
+  }
+}
@@ -45,6 +45,50 @@ extension Wayland {
       throw WaylandError.error(message: "eglMakeCurrent failed")
     }
 
-    _ = unsafe eglSwapInterval(eglDisplay, 1)
+    // Frames are paced by wl_surface.frame callbacks, EGL waiting for them as well would block the main thread.
+    _ = unsafe eglSwapInterval(eglDisplay, 0)
+
+    // Both are optional, without them every drawn frame repaints and swaps the whole buffer.
+    guard let raw = unsafe eglQueryString(eglDisplay, EGL_EXTENSIONS) else { return }
+    let extensions = unsafe String(cString: raw)
+    hasBufferAge = extensions.contains("EGL_EXT_buffer_age")
+    for (name, function) in [
+      ("EGL_KHR_swap_buffers_with_damage", "eglSwapBuffersWithDamageKHR"),
+      ("EGL_EXT_swap_buffers_with_damage", "eglSwapBuffersWithDamageEXT"),
+    ] where extensions.contains(name) {
+      unsafe swapBuffersWithDamage = unsafeBitCast(
+        eglGetProcAddress(function), to: PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC?.self)
+      hasSwapBuffersWithDamage = unsafe swapBuffersWithDamage != nil
+      break
+    }
+  }
+
+  /// Age of the back buffer about to be drawn, `0` when its contents are unknown.
+  static func bufferAge() -> Int {
+    guard hasBufferAge else { return 0 }
+    var age: EGLint = 0
+    guard unsafe eglQuerySurface(eglDisplay, eglSurface, EGL_BUFFER_AGE_EXT, &age) == EGL_TRUE else { return 0 }
+    return Int(age)
+  }
+
+  /// Presents the back buffer, telling EGL only `damage` changed when it can use that.
+  /// Without `EGL_KHR_swap_buffers_with_damage` the whole surface is damaged.
+  static func swapBuffers(damage: [DamageRect]) {
+    guard hasSwapBuffersWithDamage else {
+      _ = unsafe eglSwapBuffers(eglDisplay, eglSurface)
+      return
+    }
+    // EGL rectangles start at the bottom left.
+    var rects: [EGLint] = []
+    rects.reserveCapacity(damage.count * 4)
+    for rect in damage {
+      rects.append(EGLint(rect.x))
+      rects.append(EGLint(windowHeight - rect.y - rect.height))
+      rects.append(EGLint(rect.width))
+      rects.append(EGLint(rect.height))
+    }
+    _ = unsafe rects.withUnsafeMutableBufferPointer { p in
+      unsafe swapBuffersWithDamage?(eglDisplay, eglSurface, p.baseAddress, EGLint(damage.count))
+    }
   }
 }
@@ -111,10 +111,7 @@ extension Wayland {
 
   static func createFontAtlas() {
     let font5x7 = initFont()
-    let pixelsCount = Int(atlasW * atlasH * 4)
-    let img = UnsafeMutablePointer<UInt8>.allocate(capacity: pixelsCount)
-    unsafe img.initialize(repeating: 0, count: pixelsCount)
-    defer { unsafe img.deallocate() }
+    var img = fontPage.blankPixels()
 
     for c in Int(firstChar)...Int(lastChar) {
       let g = font5x7[c]
@@ -125,36 +122,41 @@ extension Wayland {
           for x in 0..<Int(glyphW) {
             let bit = row[x] == "1"
             let idx = Int(y * atlasW + xoff + x) * 4
-            unsafe img[idx + 0] = 255
-            unsafe img[idx + 1] = 255
-            unsafe img[idx + 2] = 255
-            unsafe img[idx + 3] = bit ? 255 : 0
+            img[idx + 0] = 255
+            img[idx + 1] = 255
+            img[idx + 2] = 255
+            img[idx + 3] = bit ? 255 : 0
           }
         }
       }
     }
 
-    unsafe glGenTextures(1, &fontTex)
-    glBindTexture(GLenum(GL_TEXTURE_2D), fontTex)
+    unsafe glGenTextures(1, &atlasTex)
+    glBindTexture(GLenum(GL_TEXTURE_2D), atlasTex)
     glPixelStorei(GLenum(GL_UNPACK_ALIGNMENT), 1)
-    unsafe glTexImage2D(
-      GLenum(GL_TEXTURE_2D), 0, GLint(GL_RGBA8), GLsizei(atlasW), GLsizei(atlasH), 0, GLenum(GL_RGBA),
-      GLenum(GL_UNSIGNED_BYTE), img)
+    unsafe img.withUnsafeBytes { p in
+      unsafe glTexImage2D(
+        GLenum(GL_TEXTURE_2D), 0, GLint(GL_RGBA8), GLsizei(atlasW), GLsizei(atlasH), 0, GLenum(GL_RGBA),
+        GLenum(GL_UNSIGNED_BYTE), p.baseAddress)
+    }
     glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_MIN_FILTER), GL_NEAREST)
     glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_MAG_FILTER), GL_NEAREST)
     glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_S), GL_CLAMP_TO_EDGE)
     glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_T), GL_CLAMP_TO_EDGE)
   }
 
-  static func glyphUV(_ c: UInt8) -> (Float, Float, Float, Float) {
-    var ch = c
-    if ch < firstChar || ch > lastChar { ch = 32 }
-    let idx = Int(ch - firstChar)
-    let xoff = idx * (Int(glyphW) + Int(glyphSpacing))
-    let u0 = Float(xoff) / Float(atlasW)
-    let u1 = Float(xoff + Int(glyphW)) / Float(atlasW)
-    let v0 = Float(1.0) - Float(glyphH) / Float(atlasH)
-    let v1 = Float(1.0)
-    return (u0, v0, u1, v1)
+  /// Cell of every byte in the font atlas, bytes without a glyph are drawn as a space.
+  static let glyphTable = InlineArray<256, UInt16> { byte in
+    byte < Int(firstChar) || byte > Int(lastChar) ? 0 : UInt16(byte - Int(firstChar))
+  }
+
+  /// Where the glyphs are in the atlas, for the vertex shader to find a glyph by
+  /// its index: the distance between two glyphs and the width of one along u,
+  /// then the top and bottom v of every glyph.
+  static var glyphCells: (advance: Float, width: Float, top: Float, bottom: Float) {
+    (
+      Float(glyphW + glyphSpacing) / Float(atlasW), Float(glyphW) / Float(atlasW),
+      Float(1.0) - Float(glyphH) / Float(atlasH), 1
+    )
   }
 }
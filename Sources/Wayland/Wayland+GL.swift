@@ -75,72 +75,45 @@ extension Wayland {
     unsafe glGenBuffers(1, &instanceVBO)
     glBindBuffer(GLenum(GL_ARRAY_BUFFER), instanceVBO)
     glBufferData(
-      GLenum(GL_ARRAY_BUFFER), 4000 * MemoryLayout<RenderableQuad>.stride, nil, GLenum(GL_DYNAMIC_DRAW))
-
-    let stride = GLsizei(MemoryLayout<RenderableQuad>.stride)
-    glEnableVertexAttribArray(1)
-    unsafe glVertexAttribPointer(
-      1, 2, GLenum(GL_FLOAT), GLboolean(GL_FALSE), stride, UnsafeRawPointer(bitPattern: 0 + 0))
-    glVertexAttribDivisor(1, 1)
-
-    let off_dst_p1 = MemoryLayout<(Float, Float)>.stride
-    glEnableVertexAttribArray(2)
-    unsafe glVertexAttribPointer(
-      2, 2, GLenum(GL_FLOAT), GLboolean(GL_FALSE), stride, UnsafeRawPointer(bitPattern: off_dst_p1))
-    glVertexAttribDivisor(2, 1)
-
-    let off_tex_tl = off_dst_p1 + MemoryLayout<(Float, Float)>.stride
-    glEnableVertexAttribArray(3)
-    unsafe glVertexAttribPointer(
-      3, 2, GLenum(GL_FLOAT), GLboolean(GL_FALSE), stride, UnsafeRawPointer(bitPattern: off_tex_tl))
-    glVertexAttribDivisor(3, 1)
-
-    let off_tex_br = off_tex_tl + MemoryLayout<(Float, Float)>.stride
-    glEnableVertexAttribArray(4)
-    unsafe glVertexAttribPointer(
-      4, 2, GLenum(GL_FLOAT), GLboolean(GL_FALSE), stride, UnsafeRawPointer(bitPattern: off_tex_br))
-    glVertexAttribDivisor(4, 1)
-
-    let off_color = off_tex_br + MemoryLayout<(Float, Float)>.stride
-    glEnableVertexAttribArray(5)
-    unsafe glVertexAttribPointer(
-      5, 4, GLenum(GL_FLOAT), GLboolean(GL_FALSE), stride, UnsafeRawPointer(bitPattern: off_color))
-    glVertexAttribDivisor(5, 1)
-
-    let off_border_color = off_color + MemoryLayout<RGB>.stride
-    glEnableVertexAttribArray(6)
-    unsafe glVertexAttribPointer(
-      6, 4, GLenum(GL_FLOAT), GLboolean(GL_FALSE), stride, UnsafeRawPointer(bitPattern: off_border_color))
-    glVertexAttribDivisor(6, 1)
-
-    let off_border_width = off_border_color + MemoryLayout<RGB>.stride
-    glEnableVertexAttribArray(7)
-    unsafe glVertexAttribPointer(
-      7, 1, GLenum(GL_FLOAT), GLboolean(GL_FALSE), stride, UnsafeRawPointer(bitPattern: off_border_width))
-    glVertexAttribDivisor(7, 1)
-
-    let off_corner_radius = off_border_width + MemoryLayout<Float>.stride
-    glEnableVertexAttribArray(8)
-    unsafe glVertexAttribPointer(
-      8, 1, GLenum(GL_FLOAT), GLboolean(GL_FALSE), stride, UnsafeRawPointer(bitPattern: off_corner_radius))
-    glVertexAttribDivisor(8, 1)
-
-    unsafe glGenTextures(1, &whiteTex)
-    glBindTexture(GLenum(GL_TEXTURE_2D), whiteTex)
-    let px: [UInt8] = [255, 255, 255, 255]
-    unsafe px.withUnsafeBytes { p in
-      unsafe glTexImage2D(
-        GLenum(GL_TEXTURE_2D), 0, GLint(GL_RGBA), 1, 1, 0, GLenum(GL_RGBA), GLenum(GL_UNSIGNED_BYTE),
-        p.baseAddress)
-    }
-    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_MIN_FILTER), GL_NEAREST)
-    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_MAG_FILTER), GL_NEAREST)
-    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_S), GL_CLAMP_TO_EDGE)
-    glTexParameteri(GLenum(GL_TEXTURE_2D), GLenum(GL_TEXTURE_WRAP_T), GL_CLAMP_TO_EDGE)
+      GLenum(GL_ARRAY_BUFFER), instanceRing.capacity * MemoryLayout<QuadInstance>.stride, nil,
+      GLenum(GL_STREAM_DRAW))
+    bindInstanceAttributes(from: 0)
 
     createFontAtlas()
 
     uTex = unsafe glGetUniformLocation(program, "uTex")
     uRes = unsafe glGetUniformLocation(program, "uRes")
+    uGlyph = unsafe glGetUniformLocation(program, "uGlyph")
+    uWhite = unsafe glGetUniformLocation(program, "uWhite")
+
+    gpuTimer = GPUTimer.make()
+  }
+
+  /// Points the instance attributes at the instance buffer, starting at instance `first`.
+  ///
+  /// GLES 3 has no base instance, so a draw that starts later in the buffer
+  /// moves the attributes instead. Expects `instanceVBO` to be bound. Integers
+  /// are read as floats, colors normalized to 0...1.
+  static func bindInstanceAttributes(from first: Int) {
+    let base = first * MemoryLayout<QuadInstance>.stride
+    let stride = GLsizei(MemoryLayout<QuadInstance>.stride)
+    func attribute(
+      _ location: GLuint, _ size: GLint, _ type: Int32, normalized: Bool = false,
+      _ field: PartialKeyPath<QuadInstance>
+    ) {
+      let offset = base + MemoryLayout<QuadInstance>.offset(of: field)!
+      glEnableVertexAttribArray(location)
+      unsafe glVertexAttribPointer(
+        location, size, GLenum(type), GLboolean(normalized ? GL_TRUE : GL_FALSE), stride,
+        UnsafeRawPointer(bitPattern: offset))
+      glVertexAttribDivisor(location, 1)
+    }
+    attribute(1, 2, GL_UNSIGNED_SHORT, \.dst_p0)
+    attribute(2, 2, GL_UNSIGNED_SHORT, \.dst_p1)
+    attribute(3, 1, GL_UNSIGNED_SHORT, \.glyph)
+    attribute(4, 4, GL_UNSIGNED_BYTE, normalized: true, \.color)
+    attribute(5, 4, GL_UNSIGNED_BYTE, normalized: true, \.borderColor)
+    // Width and radius are next to each other.
+    attribute(6, 2, GL_UNSIGNED_BYTE, \.borderWidth)
   }
 }
@@ -0,0 +1,106 @@
+import CEGL
+import CGLES3
+
+extension Wayland {
+
+  /// Whether frames are drawn into an offscreen framebuffer instead of a Wayland surface.
+  public internal(set) static var isHeadless = false
+  static var headlessFramebuffer: GLuint = 0
+  static var headlessRenderbuffer: GLuint = 0
+
+  /// Sets up the same GL program as ``setup(_:)`` without a compositor, drawing
+  /// into a `width` by `height` framebuffer.
+  ///
+  /// Uses Mesa's surfaceless platform where it is available, llvmpipe included,
+  /// and the default display otherwise. ``render(_:logLevel:)`` and
+  /// ``postDraw()`` work as usual, except that a frame is finished instead of
+  /// presented so it can be read back with ``readPixels()``.
+  public static func setupHeadless(width: UInt, height: UInt) throws(WaylandError) {
+    windowWidth = width
+    windowHeight = height
+
+    unsafe eglDisplay = eglGetPlatformDisplay(EGLenum(EGL_PLATFORM_SURFACELESS_MESA), nil, nil)
+    if unsafe eglDisplay == EGL_NO_DISPLAY {
+      unsafe eglDisplay = eglGetDisplay(nil)
+    }
+    guard unsafe eglDisplay != EGL_NO_DISPLAY else { throw WaylandError.error(message: "No headless EGL display") }
+    guard unsafe eglInitialize(eglDisplay, nil, nil) == EGL_TRUE else {
+      throw WaylandError.error(message: "eglInitialize failed")
+    }
+    guard eglBindAPI(EGLenum(EGL_OPENGL_ES_API)) == EGL_TRUE else {
+      throw WaylandError.error(message: "eglBindAPI failed")
+    }
+
+    var cfg: EGLConfig?
+    var num: EGLint = 0
+    var attrs: [EGLint] = [
+      EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+      EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,
+      EGL_NONE,
+    ]
+    unsafe attrs.withUnsafeMutableBufferPointer { p in
+      _ = unsafe eglChooseConfig(eglDisplay, p.baseAddress, &cfg, 1, &num)
+    }
+    guard num > 0, unsafe cfg != nil else { throw WaylandError.error(message: "eglChooseConfig failed") }
+
+    var ctxAttrs: [EGLint] = [EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE]
+    unsafe eglContext = ctxAttrs.withUnsafeMutableBufferPointer { p in
+      unsafe eglCreateContext(eglDisplay, cfg, EGL_NO_CONTEXT, p.baseAddress)
+    }
+    guard unsafe eglContext != EGL_NO_CONTEXT else { throw WaylandError.error(message: "eglCreateContext failed") }
+
+    // Drawing goes to the framebuffer below, a surface is only needed without EGL_KHR_surfaceless_context.
+    let extensions = unsafe eglQueryString(eglDisplay, EGL_EXTENSIONS).map { unsafe String(cString: $0) } ?? ""
+    if !extensions.contains("EGL_KHR_surfaceless_context") {
+      var pbufferAttrs: [EGLint] = [EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE]
+      unsafe eglSurface = pbufferAttrs.withUnsafeMutableBufferPointer { p in
+        unsafe eglCreatePbufferSurface(eglDisplay, cfg, p.baseAddress)
+      }
+      guard unsafe eglSurface != EGL_NO_SURFACE else {
+        throw WaylandError.error(message: "eglCreatePbufferSurface failed")
+      }
+    }
+    guard unsafe eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext) == EGL_TRUE else {
+      throw WaylandError.error(message: "eglMakeCurrent failed")
+    }
+
+    unsafe glGenRenderbuffers(1, &headlessRenderbuffer)
+    glBindRenderbuffer(GLenum(GL_RENDERBUFFER), headlessRenderbuffer)
+    glRenderbufferStorage(GLenum(GL_RENDERBUFFER), GLenum(GL_RGBA8), GLsizei(width), GLsizei(height))
+    unsafe glGenFramebuffers(1, &headlessFramebuffer)
+    glBindFramebuffer(GLenum(GL_FRAMEBUFFER), headlessFramebuffer)
+    glFramebufferRenderbuffer(
+      GLenum(GL_FRAMEBUFFER), GLenum(GL_COLOR_ATTACHMENT0), GLenum(GL_RENDERBUFFER), headlessRenderbuffer)
+    guard glCheckFramebufferStatus(GLenum(GL_FRAMEBUFFER)) == GLenum(GL_FRAMEBUFFER_COMPLETE) else {
+      throw WaylandError.error(message: "Headless framebuffer is incomplete")
+    }
+
+    isHeadless = true
+    initGL()
+  }
+
+  /// Reads the framebuffer back, the last frame drawn when running headless,
+  /// or the canvas of the software backend.
+  public static func readPixels() -> Pixels {
+    guard backend == .gl else { return SoftwareRenderer.canvas.rgbaPixels() }
+    let width = Int(windowWidth)
+    let height = Int(windowHeight)
+    var rgba = [UInt8](repeating: 0, count: width * height * 4)
+    glPixelStorei(GLenum(GL_PACK_ALIGNMENT), 1)
+    unsafe rgba.withUnsafeMutableBytes { p in
+      unsafe glReadPixels(
+        0, 0, GLsizei(width), GLsizei(height), GLenum(GL_RGBA), GLenum(GL_UNSIGNED_BYTE), p.baseAddress)
+    }
+    // GL rows start at the bottom.
+    let row = width * 4
+    for y in 0..<height / 2 {
+      let top = y * row
+      let bottom = (height - 1 - y) * row
+      for x in 0..<row {
+        rgba.swapAt(top + x, bottom + x)
+      }
+    }
+    return Pixels(width: width, height: height, rgba: rgba)
+  }
+}
@@ -5,75 +5,73 @@ extension Wayland {
   // MARK: - Renderer Protocol Conformance
 
   static func drawQuad(_ quad: RenderableQuad) {
-    glBindTexture(GLenum(GL_TEXTURE_2D), whiteTex)
-    let rects: InlineArray<1, RenderableQuad> = [quad]
-    unsafe rects.span.withUnsafeBytes { buf in
-      glBindBuffer(GLenum(GL_ARRAY_BUFFER), instanceVBO)
-      unsafe glBufferSubData(GLenum(GL_ARRAY_BUFFER), 0, MemoryLayout<RenderableQuad>.stride, buf.baseAddress)
-    }
-    glDrawArraysInstanced(GLenum(GL_TRIANGLE_STRIP), 0, 4, 1)
+    frameBatch.append(quad, texture: atlasTex)
   }
 
   static func drawText(_ text: RenderableText) {
-    var penX = text.pos.x
-    let penY = text.pos.y
-
-    var totalWidth: UInt = 0
-    for _ in text.text {
-      let w = glyphW * text.scale
-      totalWidth += w + glyphSpacing * text.scale
-    }
-    if !text.text.isEmpty {
-      totalWidth -= glyphSpacing * text.scale
-    }
-
-    let textHeight = glyphH * text.scale
-
-    drawQuad(
-      RenderableQuad(
-        dst_p0: (penX, penY),
-        dst_p1: (penX + totalWidth, penY + textHeight),
-        tex_tl: (0, 0),
-        tex_br: (1, 1),
-        color: text.background
-      )
-    )
+    frameBatch.append(text, texture: atlasTex)
+  }
 
-    // Draw text
-    glBindTexture(GLenum(GL_TEXTURE_2D), fontTex)
-    var symbols = ContiguousArray<RenderableQuad>(
-      repeating:
-        RenderableQuad(
-          dst_p0: (0, 0),
-          dst_p1: (0, 0),
-          tex_tl: (0, 0),
-          tex_br: (0, 0),
-          color: text.foreground
-        ), count: text.text.length)
+  // MARK: - Batching
 
-    penX = text.pos.x
+  /// Writes the batched instances of the frame into the next free region of
+  /// the instance ring. The region is not read by any frame still in flight,
+  /// so it is mapped unsynchronized instead of waiting for the GPU.
+  static func uploadBatch() {
+    let start = ContinuousClock.now
+    defer { profiler.record(.upload, ContinuousClock.now - start) }
+    frameStats.instances = frameBatch.instances.count
+    frameStats.glyphRunHits = frameBatch.glyphRunHits
+    frameStats.glyphRunMisses = frameBatch.glyphRunMisses
+    guard !frameBatch.isEmpty else { return }
+    let stride = MemoryLayout<QuadInstance>.stride
+    glBindBuffer(GLenum(GL_ARRAY_BUFFER), instanceVBO)
+    let region = instanceRing.reserve(
+      frameBatch.instances.count,
+      wait: { fence in
+        while unsafe glClientWaitSync(fence, GLbitfield(GL_SYNC_FLUSH_COMMANDS_BIT), 1_000_000_000)
+          == GLenum(GL_TIMEOUT_EXPIRED)
+        {}
+        unsafe glDeleteSync(fence)
+      },
+      drop: { fence in unsafe glDeleteSync(fence) })
+    if region.grew {
+      glBufferData(GLenum(GL_ARRAY_BUFFER), instanceRing.capacity * stride, nil, GLenum(GL_STREAM_DRAW))
+    }
+    batchBase = region.offset
 
-    for (i, c) in text.text.utf8.enumerated() {
-      let (u0, v0, u1, v1) = glyphUV(c)
-      let w = glyphW * text.scale
-      let h = glyphH * text.scale
-      symbols[i] = RenderableQuad(
-        dst_p0: (penX, penY),
-        dst_p1: (penX + w, penY + h),
-        tex_tl: (u0, v0),
-        tex_br: (u1, v1),
-        color: text.foreground
-      )
-      penX += w + glyphSpacing * text.scale
+    let access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT
+    unsafe frameBatch.instances.withUnsafeBytes { buf in
+      guard
+        let mapped = unsafe glMapBufferRange(
+          GLenum(GL_ARRAY_BUFFER), region.offset * stride, buf.count, GLbitfield(access))
+      else {
+        unsafe glBufferSubData(GLenum(GL_ARRAY_BUFFER), region.offset * stride, buf.count, buf.baseAddress)
+        return
+      }
+      unsafe mapped.copyMemory(from: buf.baseAddress!, byteCount: buf.count)
+      glUnmapBuffer(GLenum(GL_ARRAY_BUFFER))
     }
+  }
 
-    guard !symbols.isEmpty else { return }
+  /// Fences the instances of the frame so their region is reused once the GPU is done with them.
+  static func fenceBatch() {
+    instanceRing.commit { unsafe glFenceSync(GLenum(GL_SYNC_GPU_COMMANDS_COMPLETE), 0) }
+  }
 
-    unsafe symbols.withUnsafeBytes { buf in
-      glBindBuffer(GLenum(GL_ARRAY_BUFFER), instanceVBO)
-      unsafe glBufferSubData(
-        GLenum(GL_ARRAY_BUFFER), 0, symbols.count * MemoryLayout<RenderableQuad>.stride, buf.baseAddress)
+  /// Draws the uploaded instances, one draw call for every texture change.
+  static func drawBatch() {
+    guard !frameBatch.isEmpty else { return }
+    glBindBuffer(GLenum(GL_ARRAY_BUFFER), instanceVBO)
+    var texture: GLuint? = nil
+    for draw in frameBatch.draws {
+      if draw.texture != texture {
+        glBindTexture(GLenum(GL_TEXTURE_2D), draw.texture)
+        texture = draw.texture
+      }
+      bindInstanceAttributes(from: batchBase + draw.first)
+      glDrawArraysInstanced(GLenum(GL_TRIANGLE_STRIP), 0, 4, GLsizei(draw.count))
+      frameStats.drawCalls += 1
     }
-    glDrawArraysInstanced(GLenum(GL_TRIANGLE_STRIP), 0, 4, GLsizei(symbols.count))
   }
 }
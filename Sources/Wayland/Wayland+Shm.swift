@@ -0,0 +1,87 @@
+import CWaylandClient
+
+/// The compositor's `wl_shm`, presenting the software backend in a window.
+@MainActor
+struct WaylandShm: ShmCompositor {
+  private var pool: OpaquePointer? = nil
+
+  mutating func share(_ pool: ShmPool) {
+    if let old = self.pool {
+      unsafe wl_shm_pool_destroy(old)
+    }
+    unsafe self.pool = wl_shm_create_pool(Wayland.shm, pool.fd, Int32(pool.size))
+  }
+
+  func makeBuffer(offset: Int, width: Int, height: Int) -> OpaquePointer {
+    let buffer = unsafe wl_shm_pool_create_buffer(
+      pool, Int32(offset), Int32(width), Int32(height), Int32(width * 4), WL_SHM_FORMAT_XRGB8888.rawValue)!
+    unsafe wl_buffer_add_listener(buffer, &Wayland.bufferListener, nil)
+    return buffer
+  }
+
+  func destroy(_ buffer: OpaquePointer) {
+    unsafe wl_buffer_destroy(buffer)
+  }
+
+  func attach(_ buffer: OpaquePointer, damage: [DamageRect]?) {
+    unsafe wl_surface_attach(Wayland.surface, buffer, 0, 0)
+    if let damage {
+      for rect in damage {
+        unsafe wl_surface_damage_buffer(
+          Wayland.surface, Int32(rect.x), Int32(rect.y), Int32(rect.width), Int32(rect.height))
+      }
+    } else {
+      unsafe wl_surface_damage_buffer(Wayland.surface, 0, 0, INT32_MAX, INT32_MAX)
+    }
+    Wayland.requestFrameCallback()
+    unsafe wl_surface_commit(Wayland.surface)
+    unsafe wl_display_flush(Wayland.display)
+  }
+}
+
+extension Wayland {
+  static var shm: OpaquePointer?
+  static var _wl_shm_interface: wl_interface = unsafe wl_shm_interface
+  /// Presents software frames when the window has no EGL surface.
+  static var shmPresenter: ShmPresenter<WaylandShm>? = nil
+
+  static var bufferListener = unsafe wl_buffer_listener(
+    release: { _, buffer in
+      guard let buffer = unsafe buffer else { return }
+      unsafe shmPresenter?.release(buffer)
+    }
+  )
+
+  /// Points ``SoftwareRenderer/canvas`` at what the frame is drawn into and
+  /// returns how many frames ago that was last drawn, `0` when it holds nothing.
+  /// With a window that is a released shm buffer, without one the canvas keeps
+  /// its own pixels. `nil` when the compositor holds every buffer, the frame is
+  /// left out and the next one draws its damage as well.
+  static func beginSoftwareFrame() -> Int? {
+    guard shmPresenter != nil else {
+      SoftwareRenderer.canvas.resize(width: windowWidth, height: windowHeight)
+      SoftwareRenderer.canvas.clip = nil
+      return 1
+    }
+    do throws(WaylandError) {
+      guard let target = try shmPresenter?.acquire(width: Int(windowWidth), height: Int(windowHeight)) else {
+        return nil
+      }
+      SoftwareRenderer.canvas = unsafe SoftwareCanvas(width: windowWidth, height: windowHeight, memory: target.pixels)
+      return target.age
+    } catch let error {
+      switch error {
+      case .error(let message):
+        state = .error(reason: message)
+      }
+      return nil
+    }
+  }
+
+  /// Commits the buffer the frame was drawn into.
+  static func presentShm() {
+    _ = shmPresenter?.present(history: damageHistory)
+    // The buffer is the compositor's until it is released.
+    SoftwareRenderer.canvas = SoftwareCanvas()
+  }
+}
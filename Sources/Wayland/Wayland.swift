@@ -22,6 +22,14 @@ public enum AppMode {
   case toolbar
 }
 
+/// What draws the frames ``Wayland/render(_:logLevel:)`` renders.
+public enum RenderBackend: Sendable {
+  /// The GL program, on the GPU.
+  case gl
+  /// ``SoftwareCanvas`` on the CPU, presented through `wl_shm` buffers.
+  case software
+}
+
 public enum State {
   case running
   case error(reason: String)
@@ -56,7 +64,7 @@ public enum Wayland: Renderer {
 
   // MARK: - Constants & Metrics
 
-  public static let fontSettings: any FontMetrics = WaylandFontMetrics()
+  public static let fontSettings = WaylandFontMetrics()
   public internal(set) static var state: State = .running
 
   public static let glyphW: UInt = 5
@@ -66,8 +74,10 @@ public enum Wayland: Renderer {
   static let firstChar: UInt8 = 32
   static let lastChar: UInt8 = 126
   static let charCount = UInt(lastChar - firstChar + 1)
-  static var atlasW = Int(charCount * (glyphW + glyphSpacing))
-  static var atlasH = Int(glyphH)
+  /// Glyphs side by side, then the white block every atlas page reserves for plain quads.
+  static let fontPage = AtlasPage(contentWidth: Int(charCount * (glyphW + glyphSpacing)), contentHeight: Int(glyphH))
+  static var atlasW: Int { fontPage.width }
+  static var atlasH: Int { fontPage.height }
 
   // MARK: - Window Dimensions
 
@@ -76,12 +86,18 @@ public enum Wayland: Renderer {
   public static var windowWidth: UInt = 800
   public static var windowHeight: UInt = 600
 
+  /// Chosen before ``setup(_:)`` or the first frame, see ``RenderBackend``.
+  public static var backend: RenderBackend = .gl
+
   // MARK: - EGL State
 
   static var eglDisplay: EGLDisplay?
   static var eglContext: EGLContext?
   static var eglSurface: EGLSurface?
   static var eglWindow: OpaquePointer?
+  static var hasBufferAge = false
+  static var hasSwapBuffersWithDamage = false
+  static var swapBuffersWithDamage: PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC?
 
   static let EGL_NO_CONTEXT: EGLContext? = unsafe EGLContext(bitPattern: 0)
   static let EGL_NO_DISPLAY: EGLDisplay? = unsafe EGLDisplay(bitPattern: 0)
@@ -91,16 +107,24 @@ public enum Wayland: Renderer {
 
   static var program: GLuint = 0
   static var vao: GLuint = 0
-  static var fontTex: GLuint = 0
-  static var whiteTex: GLuint = 0
+  // Glyphs and the white texels of plain quads, see `AtlasPage`.
+  static var atlasTex: GLuint = 0
   static var quadVBO: GLuint = 0
   static var instanceVBO: GLuint = 0
+  // Which part of `instanceVBO` each frame writes, see `StreamRing`.
+  static var instanceRing = StreamRing<GLsync?>(capacity: 3 * 4000)
+  // First instance of the current frame in `instanceVBO`.
+  static var batchBase = 0
   static var uRes: GLint = 0
   static var uTex: GLint = 0
+  static var uGlyph: GLint = 0
+  static var uWhite: GLint = 0
 
   // MARK: - Wayland Protocol Objects
 
   nonisolated(unsafe) static var display: OpaquePointer!
+  // Reads the display and dispatches its listeners on the main actor.
+  static var eventLoop: EventLoop<WaylandDisplay>?
   static var registry: OpaquePointer!
   static var compositor: OpaquePointer!
   static var wmBase: OpaquePointer!
@@ -124,6 +148,33 @@ public enum Wayland: Renderer {
   static var fps: Double = 0.0
   static var fpsUpdateTime: ContinuousClock.Instant = ContinuousClock.now
 
+  // MARK: - Retained Frame
+
+  /// Skip clearing, drawing and presenting frames whose render output did not change.
+  public static var skipsUnchangedFrames = true
+  /// Frames ``render(_:logLevel:)`` found identical to the one on screen.
+  public internal(set) static var skippedFrames: UInt = 0
+  static var retainedFrame = RetainedFrame()
+  static var damageHistory = DamageHistory()
+  // What `postDraw` reports to the compositor, `nil` for the whole surface.
+  static var frameDamage: [DamageRect]? = nil
+  // Whether anything was drawn since `preDraw`, only then does `postDraw` present.
+  static var frameDrawn = false
+
+  // MARK: - Batching
+
+  static var frameBatch = FrameBatch()
+  /// What the last drawn frame cost the GPU, see ``FrameStats``.
+  public internal(set) static var frameStats = FrameStats()
+
+  // MARK: - Profiling
+
+  /// Where the time of the last frames went, see ``FramePhase``.
+  public internal(set) static var profiler = FrameProfiler()
+  /// Also times every layout walker on its own, which walks the tree seven more times a frame.
+  public static var profilesLayoutWalkers = false
+  static var gpuTimer: GPUTimer? = nil
+
   // MARK: - Public API
 
   public static func exit() {
@@ -151,24 +202,87 @@ public enum Wayland: Renderer {
 
   public static func preDraw() {
     start = ContinuousClock.now
+    frameDrawn = false
+    pacer.frameStarted()
+    applyConfigure()
+  }
+
+  /// Resizes to and acks the last configure staged since the previous frame, see ``ConfigureStage``.
+  static func applyConfigure() {
+    let (resize, ack) = configure.take(current: ConfigureStage.Size(width: windowWidth, height: windowHeight))
+    if let resize {
+      windowWidth = resize.width
+      windowHeight = resize.height
+      if let eglWindow = unsafe eglWindow {
+        unsafe wl_egl_window_resize(eglWindow, Int32(resize.width), Int32(resize.height), 0, 0)
+      }
+    }
+    if let ack {
+      if let layerSurface = unsafe layerSurface {
+        unsafe zwlr_layer_surface_v1_ack_configure(layerSurface, ack)
+      } else if let xdgSurface = unsafe xdgSurface {
+        unsafe xdg_surface_ack_configure(xdgSurface, ack)
+      }
+    }
+  }
 
+  /// Prepares the GL state for drawing. Deferred until a frame is known to have changed.
+  static func beginFrame(clear: Bool = true) {
+    frameDrawn = true
+    frameBatch.removeAll()
+    frameStats = FrameStats()
     glViewport(0, 0, GLsizei(windowWidth), GLsizei(windowHeight))
     glClearColor(0, 0, 0, 1)
-    glClear(GLbitfield(GL_COLOR_BUFFER_BIT))
+    if clear {
+      glClear(GLbitfield(GL_COLOR_BUFFER_BIT))
+    }
 
     glUseProgram(program)
     glUniform2f(uRes, Float(windowWidth), Float(windowHeight))
     glUniform1i(uTex, 0)
+    let cells = glyphCells
+    glUniform4f(uGlyph, cells.advance, cells.width, cells.top, cells.bottom)
+    glUniform2f(uWhite, fontPage.whiteUV.0, fontPage.whiteUV.1)
 
     glBindVertexArray(vao)
+    gpuTimer?.begin()
   }
 
   public static func postDraw() {
-    _ = unsafe eglSwapBuffers(eglDisplay, eglSurface)
-    unsafe wl_surface_damage_buffer(surface, 0, 0, INT32_MAX, INT32_MAX)
-    unsafe wl_surface_commit(surface)
+    let presentStart = ContinuousClock.now
+    if backend == .software {
+      // Without a window the frame stays in the canvas for `readPixels`.
+      if frameDrawn, shmPresenter != nil {
+        presentShm()
+      }
+    } else if frameDrawn, isHeadless {
+      // Nothing to present, finish the frame so it can be timed and read back.
+      gpuTimer?.end()
+      fenceBatch()
+      glFinish()
+    } else if frameDrawn {
+      gpuTimer?.end()
+      fenceBatch()
+      // eglSwapBuffers commits, the callback has to be asked for before.
+      requestFrameCallback()
+      // The swap attaches, damages and commits, damage added after it would land on the next commit.
+      if let damage = frameDamage {
+        swapBuffers(damage: damage)
+      } else {
+        _ = unsafe eglSwapBuffers(eglDisplay, eglSurface)
+      }
+      // The event loop only flushes after dispatching, a commit between events has to be sent here.
+      unsafe wl_display_flush(display)
+    }
     end = ContinuousClock.now
     elapsed = end - start
+    if frameDrawn {
+      profiler.record(.present, end - presentStart)
+    }
+    profiler.record(.frame, elapsed)
+    for time in gpuTimer?.collect() ?? [] {
+      profiler.record(.gpu, time)
+    }
   }
 
   // MARK: - Wayland Listeners
@@ -176,7 +290,9 @@ public enum Wayland: Renderer {
   static var frameListener = unsafe wl_callback_listener(
     done: { _, callback, _time in
       unsafe wl_callback_destroy(callback)
-      print("Callback")
+      if pacer.callbackDone() {
+        sendFrame()
+      }
     }
   )
 
@@ -265,8 +381,27 @@ public enum Wayland: Renderer {
       }
       unsafe wl_surface_commit(surface)
 
+      if backend == .software {
+        guard unsafe shm != nil else {
+          state = .error(reason: "No wl_shm for the software backend")
+          return
+        }
+        shmPresenter = ShmPresenter(compositor: WaylandShm())
+      } else {
+        do throws(WaylandError) {
+          try initEGL()
+        } catch let error {
+          switch error {
+          case .error(let message):
+            state = .error(reason: message)
+          }
+          return
+        }
+        initGL()
+      }
+
       do throws(WaylandError) {
-        try initEGL()
+        eventLoop = try EventLoop(WaylandDisplay()) { reason in state = .error(reason: reason) }
       } catch let error {
         switch error {
         case .error(let message):
@@ -274,13 +409,9 @@ public enum Wayland: Renderer {
         }
         return
       }
-      initGL()
-
-      DispatchQueue.global().async {
-        while unsafe wl_display_dispatch(display) != -1 {}
-      }
+      eventLoop?.start()
 
-      send(.frame(height: UInt(windowHeight), width: UInt(windowWidth)))
+      requestFrame()
     }
   }
 
@@ -300,32 +431,22 @@ public enum Wayland: Renderer {
       _ height: Int32,
       _ states: UnsafeMutablePointer<wl_array>?
     ) -> Void = { data, toplevel, width, height, states in
-      if width > 0 && height > 0 {
-        windowWidth = UInt(width)
-        windowHeight = UInt(height)
-        if unsafe eglWindow != nil {
-          unsafe wl_egl_window_resize(eglWindow, width, height, 0, 0)
-        }
-      }
+      // Applied with the xdg_surface configure that follows, when the next frame starts.
+      configure.stage(width: width, height: height)
     }
 
   static var xdgSurfaceListener = unsafe xdg_surface_listener(
     configure: { _, surface, serial in
-      unsafe xdg_surface_ack_configure(surface, serial)
+      configure.stage(serial: serial)
+      requestFrame()
     }
   )
 
   static var layerSurfaceListener = unsafe zwlr_layer_surface_v1_listener(
     configure: { data, _surface, serial, width, height in
-      windowWidth = UInt(width)
-      windowHeight = UInt(height)
-      unsafe zwlr_layer_surface_v1_ack_configure(_surface, serial)
-
-      if let eglWin = unsafe eglWindow {
-        unsafe wl_egl_window_resize(eglWin, Int32(windowWidth), Int32(windowHeight), 0, 0)
-      }
-
-      glViewport(0, 0, GLsizei(windowWidth), GLsizei(windowHeight))
+      configure.stage(width: Int32(clamping: width), height: Int32(clamping: height))
+      configure.stage(serial: serial)
+      requestFrame()
     },
     closed: { data, _surface in
       print("Layer surface closed")
@@ -353,6 +474,10 @@ public enum Wayland: Renderer {
           wl_registry_bind(registry, id, &_wl_seat_interface, min(version, 5))
         )
         unsafe wl_seat_add_listener(seat, &seatListener, nil)
+      case "wl_shm":
+        unsafe shm = OpaquePointer(
+          wl_registry_bind(registry, id, &_wl_shm_interface, 1)
+        )
       case "zwlr_layer_shell_v1":
         unsafe layerShell = OpaquePointer(
           wl_registry_bind(registry, id, &_zwlr_layer_shell_v1_interface, min(version, 4))
@@ -375,6 +500,7 @@ public enum Wayland: Renderer {
       UnsafeMutableRawPointer?, OpaquePointer?, UInt32, UInt32, UInt32, UInt32
     ) -> Void = { _, _, _, _, key, state in
       send(.key(code: UInt(key), state: UInt(state)))
+      requestFrame()
     }
 
   static let seat_capabilities_cb:
@@ -390,46 +516,99 @@ public enum Wayland: Renderer {
 
   // MARK: - Event Loop
 
-  /// I am using this event loop so that I can have async suspension points in "user space"
-  /// This is more of a hack to get around how the wayland-client library works. Because
-  /// C doesn't have a notion of async dispatch queues are used which is why we need to call
-  /// `wl_display_dispatch` on a background thread. I don't love this but this hack seems to
-  /// work well enough for now. Writing our own stand alone client should fix this but I
-  /// Don't feel like setting up the shared memory or EGL yet.
-  private static var continuation: AsyncStream<WaylandEvent>.Continuation?
+  /// I am using this event loop so that I can have async suspension points in "user space".
+  /// The listeners run on the main actor, dispatched by ``EventLoop`` as the display's fd
+  /// becomes readable, and queue what the UI needs in ``eventQueue``.
+  static var eventQueue = EventQueue()
+  // The iterator of `events()` waiting for the queue to fill.
+  static var eventsWaiting: CheckedContinuation<Void, Never>?
   private static var calledOnce = true
 
-  public static func events() -> AsyncStream<WaylandEvent> {
+  /// Events waiting for the UI.
+  public static var queuedEvents: Int { eventQueue.depth }
+  /// Frames the UI never saw because a newer frame replaced them, see ``EventQueue``.
+  public static var coalescedFrames: UInt { eventQueue.coalescedFrames }
+  /// Input dropped because the UI fell too far behind.
+  public static var droppedEvents: UInt { eventQueue.droppedEvents }
+
+  public static func events() -> WaylandEvents {
     guard calledOnce else {
       fatalError("Only call events once.")
     }
     calledOnce = false
     Task {
-      // Render loop
+      // Fallback for while no frame callback is outstanding, the compositor paces the rest.
       while Wayland.state.isRunning {
         try? await Task.sleep(for: refresh_rate)
-
-        // Calculate FPS
-        let now = ContinuousClock.now
-        let frameDelta = now - lastFrameTime
-        lastFrameTime = now
-
-        frameCount += 1
-        let fpsDelta = now - fpsUpdateTime
-        if fpsDelta >= .seconds(1) {
-          fps = Double(frameCount) / Double(fpsDelta.components.seconds)
-          frameCount = 0
-          fpsUpdateTime = now
+        if pacer.timerFired() {
+          sendFrame()
         }
-
-        send(.frame(height: UInt(windowHeight), width: UInt(windowWidth)))
       }
-      continuation?.finish()
+      eventLoop?.stop()
+      eventLoop = nil
+      resumeEvents()
     }
-    return AsyncStream { cont in continuation = cont }
+    return WaylandEvents()
+  }
+
+  // MARK: - Frame Pacing
+
+  static var pacer = FramePacer()
+  // Configures waiting for the next frame to start.
+  static var configure = ConfigureStage()
+  /// Frames sent by ``events()`` so far.
+  public internal(set) static var framesSent: UInt = 0
+
+  /// Sends a `.frame` on every refresh instead of only after ``invalidate()``,
+  /// input or a configure. Off by default, an unchanged UI costs nothing.
+  public static var rendersContinuously: Bool {
+    get { pacer.continuous }
+    set { pacer.continuous = newValue }
+  }
+
+  /// Asks for a frame, from any actor. Calls before the frame starts drawing share it.
+  public nonisolated static func invalidate() {
+    Task { @MainActor in
+      requestFrame()
+    }
+  }
+
+  static func requestFrame() {
+    if pacer.invalidate() {
+      sendFrame()
+    }
+  }
+
+  /// Asks the compositor to tell when it wants the next frame, before the commit presenting this one.
+  static func requestFrameCallback() {
+    guard let callback = unsafe wl_surface_frame(surface) else { return }
+    unsafe wl_callback_add_listener(callback, &frameListener, nil)
+    pacer.committed()
+  }
+
+  private static func sendFrame() {
+    framesSent += 1
+    let now = ContinuousClock.now
+    lastFrameTime = now
+    frameCount += 1
+    let fpsDelta = now - fpsUpdateTime
+    if fpsDelta >= .seconds(1) {
+      fps = Double(frameCount) / (fpsDelta / .seconds(1))
+      frameCount = 0
+      fpsUpdateTime = now
+    }
+    // The frame is drawn at the size staged for it, if a configure came since the last one.
+    let size = configure.size ?? ConfigureStage.Size(width: windowWidth, height: windowHeight)
+    send(.frame(height: size.height, width: size.width))
   }
 
   private static func send(_ ev: WaylandEvent) {
-    continuation?.yield(ev)
+    eventQueue.push(ev)
+    resumeEvents()
+  }
+
+  private static func resumeEvents() {
+    eventsWaiting?.resume()
+    eventsWaiting = nil
   }
 }
@@ -1,3 +1,3 @@
-enum WaylandError: Error {
+public enum WaylandError: Error {
   case error(message: String)
 }
@@ -0,0 +1,111 @@
+import CAllocationCounter
+import Testing
+
+@testable import ShapeTree
+
+@MainActor
+@Suite struct AllocationTests {
+
+  /// Only counts, so any allocation seen comes from the traversal itself.
+  struct CountingWalker: Walker {
+    var currentId: Hash = 0
+    var parentId: Hash = 0
+    var currentIndex: NodeIndex = NodeTable.none
+    var parentIndex: NodeIndex = NodeTable.none
+    var nextIndex: NodeIndex = 0
+    var visited = 0
+    var children = 0
+
+    mutating func before(_ block: some Block) {
+      visited += 1
+    }
+    mutating func after(_ block: some Block) {}
+    mutating func before(child block: some Block) {
+      children += 1
+    }
+    mutating func after(child block: some Block) {}
+  }
+
+  // Built up front, blocks stored in a Direction are not rebuilt by walking.
+  static func tree() -> some Block {
+    Direction(.vertical) {
+      Text("Title").scale(2).padding(4)
+      Direction(.horizontal) {
+        for _ in 0..<50 {
+          Text("cell")
+          Rect().width(.fixed(4)).height(.fixed(4)).background(.orange)
+        }
+      }
+      Rect().width(.grow).height(.grow)
+    }
+  }
+
+  func allocations(_ body: () -> Void) -> UInt {
+    // Warm up so one time costs like type metadata are not counted.
+    body()
+    allocation_counter_start()
+    body()
+    return UInt(allocation_counter_stop())
+  }
+
+  @Test(.enabled(if: allocation_counter_is_supported() != 0))
+  func walkingDoesNotAllocate() {
+    let block = Self.tree()
+    var walker = CountingWalker()
+    let count = allocations {
+      walker = CountingWalker()
+      block.walk(with: &walker)
+    }
+    #expect(count == 0)
+    // Three in the outer group, fifty rows and two blocks in each row.
+    #expect(walker.children == 153)
+  }
+
+  @Test(.enabled(if: allocation_counter_is_supported() != 0))
+  func walkingGroupsDoesNotAllocate() {
+    let tuple = _TupleBlock(Text("a"), Rect(), Text("b"))
+    let array = _ArrayBlock([Text("a"), Text("b"), Text("c"), Text("d")])
+    var walker = CountingWalker()
+    let count = allocations {
+      walker = CountingWalker()
+      tuple.walk(with: &walker)
+      array.walk(with: &walker)
+    }
+    #expect(count == 0)
+    #expect(walker.children == 7)
+  }
+
+  @Test(.enabled(if: allocation_counter_is_supported() != 0))
+  func groupKindsDoNotAllocate() {
+    let tuple = _TupleBlock(Text("a"), Rect(), Text("b"))
+    let array = _ArrayBlock([Text("a"), Text("b"), Text("c"), Text("d")])
+    var empty = 0
+    // Every walker asks a group for its kind, which used to build the children to count them.
+    let count = allocations {
+      empty = 0
+      if case .group(isEmpty: true) = tuple._kind { empty += 1 }
+      if case .group(isEmpty: true) = array._kind { empty += 1 }
+    }
+    #expect(count == 0)
+    #expect(empty == 0)
+    #expect(tuple.childCount == 3)
+  }
+
+  /// The other tests are skipped without a counter, on glibc that would hide a broken check.
+  @Test
+  func counterIsSupportedOnGlibc() {
+    #if os(Linux) && canImport(Glibc)
+      #expect(allocation_counter_is_supported() != 0)
+    #endif
+  }
+
+  @Test(.enabled(if: allocation_counter_is_supported() != 0))
+  func counterSeesAllocations() {
+    allocation_counter_start()
+    let values = Array(repeating: 1, count: 1_000)
+    let count = allocation_counter_stop()
+    #expect(values.count == 1_000)
+    #expect(count > 0)
+    #expect(allocation_counter_peak_bytes() >= UInt(MemoryLayout<Int>.stride * 1_000))
+  }
+}
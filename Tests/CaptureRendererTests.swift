@@ -16,10 +16,10 @@ import Testing
 
     var attributesWalker = AttributesWalker()
     block.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     block.walk(with: &sizer)
 
-    var positioner = PositionWalker(sizes: sizer.sizes.convert(), attributes: attributesWalker.attributes)
+    var positioner = PositionWalker(sizes: sizer.sizes.convert(), nodes: attributesWalker.nodes)
     block.walk(with: &positioner)
 
     var renderWalker = RenderWalker(
@@ -48,10 +48,10 @@ import Testing
     let test = QuadTestScaling()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
 
-    var positioner = PositionWalker(sizes: sizer.sizes.convert(), attributes: attributesWalker.attributes)
+    var positioner = PositionWalker(sizes: sizer.sizes.convert(), nodes: attributesWalker.nodes)
     test.walk(with: &positioner)
 
     var renderWalker = RenderWalker(
@@ -83,12 +83,11 @@ import Testing
     _ = TestUtils.render(
       test, layout: layout, with: TestUtils.CaptureRenderer.self)
 
-    guard let tupleBlock = layout.tree[0]?.first,
-      let size = layout.sizes[tupleBlock]
-    else {
+    guard layout.nodes.root != NodeTable.none else {
       Issue.record("Failed to find tuple block or get size")
       return
     }
+    let size = layout.sizes[layout.nodes.root]
 
     #expect(
       size == Container(height: Wayland.windowHeight, width: Wayland.windowWidth, orientation: .vertical),
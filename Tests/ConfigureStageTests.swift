@@ -0,0 +1,47 @@
+import Testing
+
+@testable import Wayland
+
+@Suite struct ConfigureStageTests {
+  let current = ConfigureStage.Size(width: 800, height: 600)
+
+  @Test
+  func aResizeStormIsAppliedOnce() {
+    var stage = ConfigureStage()
+    for step in 1...20 {
+      stage.stage(width: Int32(800 + step), height: Int32(600 + step))
+      stage.stage(serial: UInt32(step))
+    }
+    let applied = stage.take(current: current)
+    #expect(applied.resize == ConfigureStage.Size(width: 820, height: 620))
+    // The last serial acks all twenty configures.
+    #expect(applied.ack == 20)
+
+    let next = stage.take(current: ConfigureStage.Size(width: 820, height: 620))
+    #expect(next.resize == nil)
+    #expect(next.ack == nil)
+  }
+
+  @Test
+  func anUnchangedSizeIsOnlyAcked() {
+    var stage = ConfigureStage()
+    stage.stage(width: 900, height: 700)
+    stage.stage(width: 800, height: 600)
+    stage.stage(serial: 7)
+    let applied = stage.take(current: current)
+    // The size the layout was calculated at stands, the frame reuses it.
+    #expect(applied.resize == nil)
+    #expect(applied.ack == 7)
+  }
+
+  @Test
+  func aZeroSizeKeepsTheCurrentOne() {
+    var stage = ConfigureStage()
+    stage.stage(width: 0, height: 0)
+    stage.stage(serial: 1)
+    #expect(stage.size == nil)
+    let applied = stage.take(current: current)
+    #expect(applied.resize == nil)
+    #expect(applied.ack == 1)
+  }
+}
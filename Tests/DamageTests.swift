@@ -0,0 +1,77 @@
+import Fixtures
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite struct DamageTests {
+
+  func record(_ block: some Block) -> [RenderCommand] {
+    let layout = Wayland.calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings)
+    FrameRecorder.commands.removeAll()
+    Wayland.renderLayout(block, layout: layout, settings: Wayland.fontSettings, to: FrameRecorder.self)
+    return FrameRecorder.commands
+  }
+
+  @Test
+  func tickingCounterOnlyDamagesItsText() {
+    var frame = RetainedFrame()
+    var commands = record(Screen(scale: 2, ips: [], fps: "60.0 FPS"))
+    _ = frame.update(&commands, width: 800, height: 600)
+    #expect(frame.damage == [DamageRect(x: 0, y: 0, width: 800, height: 600)])
+
+    commands = record(Screen(scale: 2, ips: [], fps: "59.9 FPS"))
+    #expect(frame.update(&commands, width: 800, height: 600))
+    #expect(!frame.damage.isEmpty)
+    let damaged = frame.damage.reduce(0) { $0 + $1.width * $1.height }
+    #expect(damaged < 800 * 600 / 10)
+  }
+
+  @Test
+  func changedCommandDamagesOldAndNewBounds() {
+    let old: [RenderCommand] = [
+      .quad(RenderableQuad(dst_p0: (0, 0), dst_p1: (10, 10), color: Color.red.rgb())),
+      .quad(RenderableQuad(dst_p0: (100, 100), dst_p1: (110, 110), color: Color.red.rgb())),
+    ]
+    let new: [RenderCommand] = [
+      .quad(RenderableQuad(dst_p0: (0, 0), dst_p1: (10, 10), color: Color.red.rgb())),
+      .quad(RenderableQuad(dst_p0: (200, 100), dst_p1: (210, 110), color: Color.red.rgb())),
+    ]
+    let rects = RenderCommand.damage(from: old, to: new).rects
+    #expect(rects.count == 2)
+    #expect(rects.contains(DamageRect(x: 100, y: 100, width: 10, height: 10)))
+    #expect(rects.contains(DamageRect(x: 200, y: 100, width: 10, height: 10)))
+  }
+
+  @Test
+  func insertedCommandDamagesOnlyTheMiddle() {
+    let first = RenderCommand.quad(RenderableQuad(dst_p0: (0, 0), dst_p1: (10, 10), color: Color.red.rgb()))
+    let last = RenderCommand.quad(RenderableQuad(dst_p0: (50, 50), dst_p1: (60, 60), color: Color.red.rgb()))
+    let inserted = RenderCommand.quad(RenderableQuad(dst_p0: (20, 0), dst_p1: (30, 5), color: Color.blue.rgb()))
+    let rects = RenderCommand.damage(from: [first, last], to: [first, inserted, last]).rects
+    #expect(rects == [DamageRect(x: 20, y: 0, width: 10, height: 5)])
+  }
+
+  @Test
+  func overlappingRectsMerge() {
+    var region = DamageRegion()
+    region.add(DamageRect(x: 0, y: 0, width: 10, height: 10))
+    region.add(DamageRect(x: 20, y: 0, width: 10, height: 10))
+    region.add(DamageRect(x: 5, y: 5, width: 20, height: 2))
+    #expect(region.rects == [DamageRect(x: 0, y: 0, width: 30, height: 10)])
+  }
+
+  @Test
+  func bufferAgeRepaintsEveryFrameSinceThen() {
+    var history = DamageHistory()
+    history.record([DamageRect(x: 0, y: 0, width: 10, height: 10)])
+    history.record([DamageRect(x: 100, y: 0, width: 10, height: 10)])
+
+    #expect(history.repaint(age: 1) == [DamageRect(x: 100, y: 0, width: 10, height: 10)])
+    #expect(history.repaint(age: 2)?.count == 2)
+    // Unknown or too old contents redraw everything.
+    #expect(history.repaint(age: 0) == nil)
+    #expect(history.repaint(age: 3) == nil)
+  }
+}
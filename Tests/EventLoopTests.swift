@@ -0,0 +1,118 @@
+import Foundation
+import Testing
+
+@testable import Wayland
+
+/// A pipe standing in for the display, every byte written is an event.
+final class PipeSource: EventSource, @unchecked Sendable {
+  let fd: Int32
+  private let writeEnd: Int32
+  private let lock = NSLock()
+  private var queued = 0
+  private var dispatchedCount = 0
+
+  init() {
+    var fds: [Int32] = [0, 0]
+    _ = unsafe pipe(&fds)
+    fd = fds[0]
+    writeEnd = fds[1]
+  }
+
+  /// Events run on the main actor so far.
+  var dispatched: Int {
+    lock.withLock { dispatchedCount }
+  }
+
+  func send(_ events: Int) {
+    let bytes = [UInt8](repeating: 0, count: events)
+    _ = unsafe write(writeEnd, bytes, events)
+  }
+
+  /// Closes the pipe the way a compositor going away closes the socket.
+  func hangUp() {
+    close(writeEnd)
+  }
+
+  func prepareRead() -> Bool {
+    lock.withLock { queued == 0 }
+  }
+
+  func cancelRead() {}
+
+  func readEvents() -> Bool {
+    var bytes = [UInt8](repeating: 0, count: 64)
+    let count = unsafe read(fd, &bytes, bytes.count)
+    guard count > 0 else { return false }
+    lock.withLock { queued += count }
+    return true
+  }
+
+  func flush() {}
+
+  @MainActor func dispatchPending() -> Bool {
+    lock.withLock {
+      dispatchedCount += queued
+      queued = 0
+    }
+    return true
+  }
+}
+
+@MainActor
+final class Failure {
+  var reason: String? = nil
+}
+
+@MainActor
+@Suite struct EventLoopTests {
+
+  /// Gives the loop's thread up to a second to get `condition` true.
+  func eventually(_ condition: () -> Bool) async throws {
+    var attempts = 0
+    while !condition(), attempts < 100 {
+      try await Task.sleep(for: .milliseconds(10))
+      attempts += 1
+    }
+  }
+
+  @Test
+  func eventsAreDispatchedOnTheMainActor() async throws {
+    let source = PipeSource()
+    let loop = try EventLoop(source) { _ in }
+    loop.start()
+    source.send(3)
+    try await eventually { source.dispatched == 3 }
+    #expect(source.dispatched == 3)
+
+    source.send(2)
+    try await eventually { source.dispatched == 5 }
+    #expect(source.dispatched == 5)
+    loop.stop()
+  }
+
+  @Test
+  func aLostConnectionIsReported() async throws {
+    let source = PipeSource()
+    let failure = Failure()
+    let loop = try EventLoop(source) { failure.reason = $0 }
+    loop.start()
+    source.hangUp()
+    try await eventually { failure.reason != nil }
+    #expect(failure.reason != nil)
+    #expect(source.dispatched == 0)
+  }
+
+  @Test
+  func stoppingAfterTheLoopEndedIsHarmless() async throws {
+    let source = PipeSource()
+    let failure = Failure()
+    let loop = try EventLoop(source) { failure.reason = $0 }
+    loop.start()
+    source.hangUp()
+    try await eventually { failure.reason != nil }
+    // The thread has returned, the wake fd is still the loop's to write to.
+    loop.stop()
+    loop.stop()
+    #expect(failure.reason == "Lost the connection to the Wayland display.")
+  }
+}
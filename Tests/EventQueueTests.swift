@@ -0,0 +1,69 @@
+import Testing
+
+@testable import Wayland
+
+@Suite struct EventQueueTests {
+
+  func drain(_ queue: inout EventQueue) -> [WaylandEvent] {
+    var batch: [WaylandEvent] = []
+    queue.drain(into: &batch)
+    return batch
+  }
+
+  /// Frames as their size and keys as their code, to compare batches.
+  func describe(_ batch: [WaylandEvent]) -> [String] {
+    batch.map { event in
+      switch event {
+      case .frame(let height, let width): "\(width)x\(height)"
+      case .key(let code, _): "key \(code)"
+      }
+    }
+  }
+
+  @Test
+  func framesCoalesceBehindTheInput() {
+    var queue = EventQueue()
+    queue.push(.frame(height: 600, width: 800))
+    queue.push(.key(code: 1, state: 1))
+    // A drag resize configures again before the UI took the first frame.
+    queue.push(.frame(height: 610, width: 820))
+    queue.push(.key(code: 2, state: 1))
+    queue.push(.frame(height: 620, width: 840))
+    #expect(queue.depth == 3)
+    let batch = drain(&queue)
+    #expect(describe(batch) == ["key 1", "key 2", "840x620"])
+    #expect(queue.coalescedFrames == 2)
+    #expect(queue.depth == 0)
+    let empty = drain(&queue)
+    #expect(empty.isEmpty)
+  }
+
+  @Test
+  func aFullRingDropsNewInput() {
+    var queue = EventQueue(capacity: 4)
+    for code in 0..<6 {
+      queue.push(.key(code: UInt(code), state: 1))
+    }
+    // Frames are never dropped for input, there is room for the newest.
+    queue.push(.frame(height: 1, width: 1))
+    #expect(queue.depth == 5)
+    #expect(queue.droppedEvents == 2)
+    let batch = drain(&queue)
+    #expect(describe(batch) == ["key 0", "key 1", "key 2", "key 3", "1x1"])
+  }
+
+  @Test
+  func theRingWrapsAround() {
+    var queue = EventQueue(capacity: 4)
+    var taken: [String] = []
+    for code in 0..<10 {
+      queue.push(.key(code: UInt(code), state: 1))
+      if code % 3 == 2 {
+        taken += describe(drain(&queue))
+      }
+    }
+    taken += describe(drain(&queue))
+    #expect(taken == (0..<10).map { "key \($0)" })
+    #expect(queue.droppedEvents == 0)
+  }
+}
@@ -0,0 +1,148 @@
+import Fixtures
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite struct FrameBatchTests {
+
+  func batched(_ block: some Block) -> (FrameBatch, [RenderCommand]) {
+    let layout = Wayland.calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings)
+    FrameRecorder.commands.removeAll()
+    Wayland.renderLayout(block, layout: layout, settings: Wayland.fontSettings, to: FrameRecorder.self)
+    var batch = FrameBatch()
+    for command in FrameRecorder.commands {
+      switch command {
+      case .quad(let quad):
+        batch.append(quad, texture: 1)
+      case .text(let text):
+        batch.append(text, texture: 1)
+      }
+    }
+    return (batch, FrameRecorder.commands)
+  }
+
+  @Test
+  func everyQuadAndGlyphIsOneInstance() {
+    let (batch, commands) = batched(Screen(scale: 2, ips: ["1.1.1.1", "10.0.0.2"], fps: "60 FPS"))
+    let expected = commands.reduce(0) { count, command in
+      switch command {
+      case .quad: count + 1
+      case .text(let text): count + 1 + text.text.utf8.count
+      }
+    }
+    #expect(batch.instances.count == expected)
+  }
+
+  @Test
+  func drawsSplitOnlyWhereTheTextureChanges() {
+    let quad = RenderableQuad(dst_p0: (0, 0), dst_p1: (4, 4), color: Color.red.rgb())
+    var batch = FrameBatch()
+    for texture: UInt32 in [1, 1, 2, 2, 2, 1] {
+      batch.append(quad, texture: texture)
+    }
+    batch.append(RenderableText("ab", at: (x: 0, y: 0), scale: 1), texture: 1)
+    #expect(
+      batch.draws == [
+        FrameBatch.Draw(texture: 1, first: 0, count: 2),
+        FrameBatch.Draw(texture: 2, first: 2, count: 3),
+        FrameBatch.Draw(texture: 1, first: 5, count: 4),
+      ])
+  }
+
+  @Test
+  func renderedFrameIsOneDraw() {
+    let (batch, commands) = batched(SystemToolbar(battery: "69%", batteryColor: .pink, time: "12:00"))
+    #expect(commands.count > 1)
+    #expect(batch.draws == [FrameBatch.Draw(texture: 1, first: 0, count: batch.instances.count)])
+  }
+
+  @Test
+  func textMatchesItsGlyphs() {
+    var batch = FrameBatch()
+    batch.append(
+      RenderableText("ab", at: (x: 10, y: 20), scale: 2, foreground: Color.red.rgb()), texture: 1)
+    #expect(batch.instances.count == 3)
+    // Two glyphs of 5 pixels and the space between them, all scaled by 2.
+    #expect(batch.instances[0].dst_p0 == (10, 20))
+    #expect(batch.instances[0].dst_p1 == (32, 34))
+    #expect(batch.instances[0].glyph == QuadInstance.plain)
+    #expect(batch.instances[2].dst_p0 == (22, 20))
+    #expect(batch.instances.dropFirst().map(\.glyph) == [65, 66])
+    #expect(batch.instances[1].color == RGBA8(r: 255, g: 0, b: 0, a: 255))
+
+    batch.removeAll()
+    #expect(batch.isEmpty)
+    #expect(batch.draws.isEmpty)
+  }
+
+  /// One glyph at a time, the way runs were laid out before they were vectorized.
+  func scalarLayOut(_ text: RenderableText) -> [QuadInstance] {
+    let advance = (Wayland.glyphW + Wayland.glyphSpacing) * text.scale
+    let y0 = UInt16(clamping: text.pos.y)
+    let y1 = UInt16(clamping: text.pos.y + Wayland.glyphH * text.scale)
+    var penX = text.pos.x
+    return text.text.utf8.map { c in
+      defer { penX += advance }
+      let index = c < 32 || c > 126 ? 0 : UInt16(c - 32)
+      return QuadInstance(
+        dst_p0: (UInt16(clamping: penX), y0), dst_p1: (UInt16(clamping: penX + Wayland.glyphW * text.scale), y1),
+        glyph: index, color: RGBA8(text.foreground))
+    }
+  }
+
+  @Test
+  func vectorizedRunsMatchScalarLayout() {
+    let sample = "The quick brown fox jumps over the lazy dog. 0123456789 ~{}|\u{7F}é"
+    for length in [0, 1, 15, 16, 17, 33, sample.utf8.count] {
+      for (x, scale) in [(UInt(0), UInt(1)), (7, 3), (65_000, 1), (70_000, 2), (10, 20_000)] {
+        let string = String(decoding: sample.utf8.prefix(length), as: UTF8.self)
+        let text = RenderableText(string, at: (x: x, y: 5), scale: scale, foreground: Color.cyan.rgb())
+        var instances: [QuadInstance] = []
+        FrameBatch.layOut(text, at: text.pos, into: &instances)
+        #expect(Array(instances.dropFirst()) == scalarLayOut(text))
+      }
+    }
+  }
+
+  @Test
+  func instancesArePacked() {
+    #expect(MemoryLayout<QuadInstance>.stride == 20)
+    let quad = RenderableQuad(
+      dst_p0: (3, 4), dst_p1: (70_000, 8), color: RGB(r: 0.5, g: 1.5, b: -1, a: 1),
+      borderColor: Color.white.rgb(), borderWidth: 2, cornerRadius: 300)
+    let packed = QuadInstance(quad)
+    #expect(packed.dst_p0 == (3, 4))
+    // Rectangles past the largest coordinate and radii past a byte are clamped.
+    #expect(packed.dst_p1 == (UInt16.max, 8))
+    #expect(packed.color == RGBA8(r: 128, g: 255, b: 0, a: 255))
+    #expect(packed.borderColor == RGBA8(r: 255, g: 255, b: 255, a: 255))
+    #expect(packed.borderWidth == 2 && packed.cornerRadius == 255)
+    #expect(packed.glyph == QuadInstance.plain)
+    // Characters without a glyph are spaces.
+    #expect(Wayland.glyphTable[Int(UInt8(ascii: " "))] == 0)
+    #expect(Wayland.glyphTable[0x7F] == 0)
+    #expect(Wayland.glyphTable[0xE2] == 0)
+    #expect(Wayland.glyphTable[Int(UInt8(ascii: "~"))] == 94)
+  }
+
+  @Test
+  func atlasReservesWhiteTexels() {
+    let page = Wayland.fontPage
+    let pixels = page.blankPixels()
+    #expect(pixels.count == page.width * page.height * 4)
+    // The texel plain quads sample and every texel around it are opaque white.
+    let (u, v) = page.whiteUV
+    let x = Int(u * Float(page.width))
+    let y = Int(v * Float(page.height))
+    for dy in -1...1 {
+      for dx in -1...1 {
+        let idx = ((y + dy) * page.width + x + dx) * 4
+        #expect(pixels[idx..<idx + 4].allSatisfy { $0 == 255 })
+      }
+    }
+    // Content is left for the glyphs.
+    #expect(pixels[0..<page.contentWidth * 4].allSatisfy { $0 == 0 })
+  }
+}
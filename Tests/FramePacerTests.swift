@@ -0,0 +1,131 @@
+import Testing
+
+@testable import Wayland
+
+@Suite struct FramePacerTests {
+
+  /// Whether each timer tick sends a frame.
+  func ticks(_ pacer: inout FramePacer, _ count: Int) -> [Bool] {
+    (0..<count).map { _ in pacer.timerFired() }
+  }
+
+  func continuous() -> FramePacer {
+    var pacer = FramePacer()
+    pacer.continuous = true
+    return pacer
+  }
+
+  @Test
+  func timerStartsFramesUntilTheFirstCommit() {
+    var pacer = continuous()
+    // Until the frame starts drawing another one would stack up.
+    #expect(ticks(&pacer, 2) == [true, false])
+    pacer.frameStarted()
+    #expect(ticks(&pacer, 1) == [true])
+  }
+
+  @Test
+  func callbacksPaceCommittedFrames() {
+    var pacer = continuous()
+    _ = pacer.timerFired()
+    pacer.frameStarted()
+    pacer.committed()
+    // A hidden surface never answers, the timer stays quiet meanwhile.
+    #expect(!ticks(&pacer, 10).contains(true))
+    let sent = pacer.callbackDone()
+    #expect(sent)
+    #expect(ticks(&pacer, 1) == [false])
+  }
+
+  @Test
+  func framesThatCommitNothingFallBackToTheTimer() {
+    var pacer = continuous()
+    pacer.committed()
+    _ = pacer.callbackDone()
+    pacer.frameStarted()
+    // Nothing changed, so nothing was committed and no callback will come.
+    #expect(!pacer.awaitingCallback)
+    #expect(ticks(&pacer, 1) == [true])
+  }
+
+  @Test
+  func aCallbackDuringAPendingFrameSendsNothing() {
+    var pacer = continuous()
+    _ = pacer.timerFired()
+    pacer.committed()
+    let sent = pacer.callbackDone()
+    #expect(!sent)
+    #expect(pacer.framePending)
+  }
+
+  @Test
+  func idleFramesAreNotEmitted() {
+    var pacer = FramePacer()
+    // A second of refreshes with nothing changed.
+    #expect(ticks(&pacer, 60).count(where: { $0 }) == 0)
+
+    let sent = pacer.invalidate()
+    #expect(sent)
+    pacer.frameStarted()
+    pacer.committed()
+    let afterCallback = pacer.callbackDone()
+    #expect(!afterCallback)
+    #expect(ticks(&pacer, 60).count(where: { $0 }) == 0)
+  }
+
+  @Test
+  func invalidationsShareAFrame() {
+    var pacer = FramePacer()
+    let sent = (0..<5).map { _ in pacer.invalidate() }
+    #expect(sent == [true, false, false, false, false])
+    pacer.frameStarted()
+    pacer.committed()
+    // Invalidated while the compositor shows the frame, the callback sends the next one.
+    let whileShowing = pacer.invalidate()
+    #expect(!whileShowing)
+    let next = pacer.callbackDone()
+    #expect(next)
+  }
+}
+
+@MainActor
+@Suite struct InvalidationTests {
+
+  /// A pacer of its own, invalidated through the same hop as ``Wayland/invalidate()``,
+  /// so drawing suites running alongside cannot start its frame.
+  @MainActor
+  final class Window {
+    var pacer = FramePacer()
+    var invalidations = 0
+    var framesSent = 0
+
+    nonisolated func invalidate() {
+      Task { @MainActor in
+        invalidations += 1
+        if pacer.invalidate() {
+          framesSent += 1
+        }
+      }
+    }
+  }
+
+  actor Clock {
+    func tick(_ window: Window) {
+      window.invalidate()
+    }
+  }
+
+  @Test
+  func invalidatingFromAnotherActorSendsOneFrame() async {
+    let window = Window()
+    let clock = Clock()
+    for _ in 0..<5 {
+      await clock.tick(window)
+    }
+    while window.invalidations < 5 {
+      await Task.yield()
+    }
+    // Nothing starts drawing the frame, so the other invalidations wait for it.
+    #expect(window.framesSent == 1)
+  }
+}
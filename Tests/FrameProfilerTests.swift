@@ -0,0 +1,88 @@
+import Fixtures
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite struct FrameProfilerTests {
+
+  @Test
+  func statsOfTheSamplesKept() {
+    var profiler = FrameProfiler()
+    #expect(profiler.stats(.render) == nil)
+    for ms in 1...100 {
+      profiler.record(.render, .milliseconds(ms))
+    }
+    let stats = profiler.stats(.render)
+    #expect(stats?.samples == 100)
+    #expect(stats?.min == .milliseconds(1))
+    #expect(stats?.average == .microseconds(50_500))
+    #expect(stats?.p99 == .milliseconds(99))
+    // Other phases are kept apart.
+    #expect(profiler.stats(.upload) == nil)
+  }
+
+  @Test
+  func ringKeepsTheNewestSamples() {
+    var profiler = FrameProfiler()
+    let total = FrameProfiler.capacity + 10
+    for ms in 0..<total {
+      profiler.record(.frame, .milliseconds(ms))
+    }
+    #expect(profiler.samples(.frame) == (10..<total).map { .milliseconds($0) })
+    #expect(profiler.stats(.frame)?.min == .milliseconds(10))
+
+    profiler.removeAll()
+    #expect(profiler.samples(.frame).isEmpty)
+  }
+
+  @Test
+  func layoutReportsBothPasses() {
+    var passes: [LayoutPass] = []
+    _ = ShapeTree.calculateLayout(
+      Screen(scale: 2, ips: [], fps: "60 FPS"), height: 600, width: 800, settings: Wayland.fontSettings
+    ) { pass, duration in
+      passes.append(pass)
+      #expect(duration >= .zero)
+    }
+    #expect(passes == [.measure, .place])
+  }
+
+  @Test
+  func renderingRecordsItsPhases() {
+    let block = Screen(scale: 2, ips: [], fps: "60 FPS")
+    let layout = Wayland.calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings)
+    FrameRecorder.commands.removeAll()
+    Wayland.renderLayout(block, layout: layout, settings: Wayland.fontSettings, to: FrameRecorder.self)
+    for phase in [FramePhase.measure, .place, .render] {
+      #expect(!Wayland.profiler.samples(phase).isEmpty)
+    }
+  }
+
+  @Test
+  func layoutWalkersAreTimedWhenAskedFor() {
+    let block = Screen(scale: 2, ips: [], fps: "60 FPS")
+    Wayland.profiler.removeAll()
+    _ = Wayland.calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings)
+    #expect(Wayland.profiler.samples(.grow).isEmpty)
+
+    Wayland.profilesLayoutWalkers = true
+    defer { Wayland.profilesLayoutWalkers = false }
+    _ = Wayland.calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings)
+    for phase in [FramePhase.attributes, .size, .grow, .position] {
+      #expect(Wayland.profiler.samples(phase).count == 1)
+    }
+  }
+
+  @Test
+  func graphBarsAreScaledToTheBudget() {
+    let graph = FrameGraph(
+      samples: [.milliseconds(4), .milliseconds(16), .milliseconds(64)], budget: .milliseconds(16))
+    #expect(graph.barHeight(.milliseconds(4)) == 5)
+    #expect(graph.barHeight(.milliseconds(16)) == 20)
+    #expect(graph.barHeight(.milliseconds(64)) == 40)
+    let layout = calculateLayout(graph)
+    #expect(layout.nodes.count > 3 * 2)
+  }
+}
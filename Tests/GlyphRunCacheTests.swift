@@ -0,0 +1,89 @@
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite struct GlyphRunCacheTests {
+
+  func key(_ text: String) -> GlyphRunCache.Key {
+    GlyphRunCache.Key(
+      text: text, scale: 1, foreground: RGBA8(Color.white.rgb()), background: RGBA8(Color.black.rgb()))
+  }
+
+  func run(_ length: Int) -> [QuadInstance] {
+    Array(repeating: QuadInstance(dst_p0: (0, 0), dst_p1: (1, 1), color: RGBA8(r: 0, g: 0, b: 0, a: 0)), count: length)
+  }
+
+  @Test
+  func leastRecentlyUsedRunIsDropped() {
+    var cache = GlyphRunCache(capacity: 2)
+    cache.insert(run(1), for: key("a"))
+    cache.insert(run(2), for: key("b"))
+    // Using "a" makes "b" the least recently used.
+    #expect(cache.run(for: key("a"))?.count == 1)
+    cache.insert(run(3), for: key("c"))
+    #expect(cache.count == 2)
+    #expect(cache.run(for: key("b")) == nil)
+    #expect(cache.run(for: key("a"))?.count == 1)
+    #expect(cache.run(for: key("c"))?.count == 3)
+
+    // Replacing a run keeps a single entry.
+    cache.insert(run(4), for: key("c"))
+    #expect(cache.count == 2)
+    #expect(cache.run(for: key("c"))?.count == 4)
+  }
+
+  @Test
+  func manyInsertsKeepTheMostRecentRuns() {
+    var cache = GlyphRunCache(capacity: 8)
+    for i in 0..<100 {
+      cache.insert(run(i), for: key("\(i)"))
+      if i % 3 == 0 {
+        _ = cache.run(for: key("0"))
+      }
+    }
+    #expect(cache.count == 8)
+    #expect(cache.run(for: key("0")) != nil)
+    for i in 93..<100 {
+      #expect(cache.run(for: key("\(i)"))?.count == i)
+    }
+  }
+
+  @Test
+  func hitsMoveTheCachedRun() {
+    let texts = [
+      RenderableText("12:00", at: (x: 10, y: 20), scale: 2),
+      RenderableText("12:00", at: (x: 300, y: 4), scale: 2),
+      RenderableText("69%", at: (x: 0, y: 0), scale: 1, foreground: Color.pink.rgb()),
+      RenderableText("12:00", at: (x: 10, y: 20), scale: 1),
+    ]
+    var batch = FrameBatch()
+    var expected: [QuadInstance] = []
+    for text in texts {
+      batch.append(text, texture: 1)
+      FrameBatch.layOut(text, at: text.pos, into: &expected)
+    }
+    #expect(batch.instances == expected)
+    // Only the second text is the same as one before, the last has another scale.
+    #expect(batch.glyphRunHits == 1)
+    #expect(batch.glyphRunMisses == 3)
+
+    batch.removeAll()
+    for text in texts {
+      batch.append(text, texture: 1)
+    }
+    #expect(batch.instances == expected)
+    #expect(batch.glyphRunHits == 4)
+    #expect(batch.glyphRunMisses == 0)
+  }
+
+  @Test
+  func hitRate() {
+    var stats = FrameStats()
+    #expect(stats.glyphRunHitRate == 0)
+    stats.glyphRunHits = 3
+    stats.glyphRunMisses = 1
+    #expect(stats.glyphRunHitRate == 0.75)
+  }
+}
@@ -0,0 +1,104 @@
+import Fixtures
+import Foundation
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite(.serialized, .enabled { await TestUtils.headless })
+struct HeadlessTests {
+
+  func draw(_ block: some Block) -> Pixels {
+    Wayland.retainedFrame.invalidate()
+    Wayland.preDraw()
+    Wayland.render(block)
+    Wayland.postDraw()
+    return Wayland.readPixels()
+  }
+
+  @Test
+  func quadsAndTextReachTheFramebuffer() {
+    let pixels = draw(
+      Direction(.vertical) {
+        Rect().width(.fixed(40)).height(.fixed(20)).background(.red)
+        Text("Hi").foreground(.white).background(.blue)
+      })
+    #expect(pixels.width == 800 && pixels.height == 600)
+    #expect(pixels.pixel(x: 10, y: 10) == (255, 0, 0, 255))
+    // Text sits below the quad, its background shows between the glyphs.
+    #expect(pixels.pixel(x: 5, y: 21) == (0, 0, 255, 255))
+    #expect(pixels.pixel(x: 100, y: 100) == (0, 0, 0, 255))
+    #expect(Wayland.frameStats.drawCalls == 1)
+  }
+
+  @Test(arguments: ["screen", "borders", "toolbar"])
+  func fixturesRender(_ name: String) throws {
+    let pixels =
+      switch name {
+      case "screen": draw(Screen(scale: 2, ips: ["1.1.1.1", "10.0.0.2"], fps: "60 FPS"))
+      case "borders": draw(Borders(scale: 2))
+      default: draw(SystemToolbar(battery: "69%", batteryColor: .pink, time: "12:00"))
+      }
+    #expect(Wayland.frameStats.drawCalls == 1)
+    let lit = stride(from: 0, to: pixels.rgba.count, by: 4).count { idx in
+      pixels.rgba[idx] > 0 || pixels.rgba[idx + 1] > 0 || pixels.rgba[idx + 2] > 0
+    }
+    #expect(lit > 0)
+    let path = FileManager.default.temporaryDirectory.appendingPathComponent("headless-\(name).ppm").path
+    try pixels.write(ppm: path)
+    #expect(FileManager.default.fileExists(atPath: path))
+  }
+
+  @Test(arguments: ["screen", "borders", "toolbar"])
+  func softwareMatchesGL(_ name: String) {
+    func fixture() -> Pixels {
+      switch name {
+      case "screen": draw(Screen(scale: 2, ips: ["1.1.1.1", "10.0.0.2"], fps: "60 FPS"))
+      case "borders": draw(Borders(scale: 2))
+      default: draw(SystemToolbar(battery: "69%", batteryColor: .pink, time: "12:00"))
+      }
+    }
+    let gl = fixture()
+    Wayland.backend = .software
+    defer { Wayland.backend = .gl }
+    let software = fixture()
+    // Rounded corners are covered partially on the CPU and only kept or discarded by the shader.
+    #expect(software.countDifferences(from: gl, tolerance: 2) * 100 < software.width * software.height)
+  }
+
+  @Test
+  func instancesOutgrowingTheRingAreDrawn() {
+    let columns = 12_000
+    let advance = Int(Wayland.glyphW + Wayland.glyphSpacing)
+    // The ring grows on each of the first three frames, the last one reuses it.
+    for rows in [1, 4, 9, 9] {
+      let pixels = draw(
+        Direction(.vertical) {
+          for _ in 0..<rows {
+            Text(String(repeating: "x", count: columns)).foreground(.white).background(.blue)
+          }
+          Rect().width(.fixed(40)).height(.fixed(20)).background(.red)
+        })
+      #expect(Wayland.frameStats.instances == rows * (columns + 1) + 1)
+      #expect(Wayland.frameStats.drawCalls == 1)
+      // The spacing after a glyph shows the background, in the first row and the last.
+      let lastRow = (rows - 1) * Int(Wayland.glyphH)
+      #expect(pixels.pixel(x: Int(Wayland.glyphW), y: 3) == (0, 0, 255, 255))
+      #expect(pixels.pixel(x: 100 * advance + Int(Wayland.glyphW), y: lastRow + 3) == (0, 0, 255, 255))
+      // The quad is the last instance of the frame.
+      #expect(pixels.pixel(x: 10, y: rows * Int(Wayland.glyphH) + 10) == (255, 0, 0, 255))
+    }
+    #expect(Wayland.instanceRing.capacity >= 3 * (9 * (columns + 1) + 1))
+  }
+}
+
+@Suite struct PixelsTests {
+
+  @Test
+  func ppmDropsAlpha() {
+    let pixels = Pixels(width: 2, height: 1, rgba: [255, 0, 0, 255, 1, 2, 3, 4])
+    #expect(pixels.pixel(x: 1, y: 0) == (1, 2, 3, 4))
+    #expect(pixels.ppm() == Array("P6\n2 1\n255\n".utf8) + [255, 0, 0, 1, 2, 3])
+  }
+}
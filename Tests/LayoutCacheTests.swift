@@ -0,0 +1,69 @@
+import Fixtures
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite struct LayoutCacheTests {
+
+  func expectEqual(_ cached: Layout, _ fresh: Layout) {
+    #expect(cached.nodes.ids.elementsEqual(fresh.nodes.ids))
+    #expect(cached.sizes.elementsEqual(fresh.sizes))
+    #expect(cached.positions.elementsEqual(fresh.positions) { $0 == $1 })
+  }
+
+  @Test
+  func unchangedFrameReusesEverything() {
+    let cache = LayoutCache()
+    let block = Screen(scale: 2, ips: ["1.1.1.1"], fps: "60.0 FPS")
+    let first = calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings, cache: cache)
+    #expect(cache.reusedNodes == 0)
+
+    let second = calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings, cache: cache)
+    // Everything below the root is copied.
+    #expect(cache.reusedNodes == second.nodes.count - 1)
+    expectEqual(second, first)
+  }
+
+  @Test
+  func changedTextOnlyLaysOutItsPath() {
+    let cache = LayoutCache()
+    _ = calculateLayout(
+      Screen(scale: 2, ips: ["1.1.1.1"], fps: "60.0 FPS"), height: 600, width: 800,
+      settings: Wayland.fontSettings, cache: cache)
+
+    let block = Screen(scale: 2, ips: ["1.1.1.1"], fps: "59.9 FPS")
+    let cached = calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings, cache: cache)
+    let fresh = calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings)
+
+    #expect(cache.reusedNodes > 0)
+    #expect(cache.reusedNodes < cached.nodes.count - 1)
+    expectEqual(cached, fresh)
+  }
+
+  @Test
+  func changedStructureMatchesFreshLayout() {
+    let cache = LayoutCache()
+    _ = calculateLayout(
+      Screen(scale: 2, ips: ["1.1.1.1"], fps: "60.0 FPS"), height: 600, width: 800,
+      settings: Wayland.fontSettings, cache: cache)
+
+    // Adds nodes in the middle so every later subtree moves to a new index.
+    let block = Screen(scale: 2, ips: ["1.1.1.1", "2.2.2.2", "3.3.3.3"], fps: "60.0 FPS")
+    let cached = calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings, cache: cache)
+    let fresh = calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings)
+    expectEqual(cached, fresh)
+  }
+
+  @Test
+  func resizedWindowMatchesFreshLayout() {
+    let cache = LayoutCache()
+    let block = Screen(scale: 2, ips: [], fps: "60.0 FPS")
+    _ = calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings, cache: cache)
+
+    let cached = calculateLayout(block, height: 300, width: 1024, settings: Wayland.fontSettings, cache: cache)
+    let fresh = calculateLayout(block, height: 300, width: 1024, settings: Wayland.fontSettings)
+    expectEqual(cached, fresh)
+  }
+}
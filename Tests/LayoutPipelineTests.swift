@@ -15,18 +15,18 @@ import Testing
 
     #expect(layout.positions.count > 0)
     #expect(layout.sizes.count > 0)
-    #expect(layout.tree.count > 0)
+    #expect(layout.nodes.count > 0)
 
-    #expect(layout.tree[0] != nil)
-    let root = layout.tree[0]!.first!
-    #expect(layout.positions[root] != nil)
-    #expect(layout.sizes[root] != nil)
+    #expect(layout.nodes.root != NodeTable.none)
+    let root = layout.nodes.root
+    #expect(layout.positions.indices.contains(root))
+    #expect(layout.sizes.indices.contains(root))
 
-    let pos = layout.positions[root]!
+    let pos = layout.positions[root]
     #expect(pos.x == 0)
     #expect(pos.y == 0)
 
-    let size = layout.sizes[root]!
+    let size = layout.sizes[root]
     #expect(size.width <= Wayland.windowWidth)
     #expect(size.height <= Wayland.windowHeight)
   }
@@ -49,10 +49,50 @@ import Testing
     let layout = Wayland.calculateLayout(block, height: 50, width: 300, settings: Wayland.fontSettings)
 
     #expect(layout.positions.count == layout.sizes.count)
-    #expect(layout.tree.count > 0)
+    #expect(layout.nodes.count == layout.sizes.count)
 
-    for id in layout.positions.keys {
-      #expect(layout.sizes[id] != nil)
+    for index in layout.positions.indices {
+      #expect(layout.sizes.indices.contains(index))
     }
   }
+
+  struct RecordingVisitor: TableVisitor {
+    var entered: [NodeIndex] = []
+    var exited: [NodeIndex] = []
+
+    mutating func enter(_ index: NodeIndex) -> Bool {
+      entered.append(index)
+      return true
+    }
+
+    mutating func exit(_ index: NodeIndex) {
+      exited.append(index)
+    }
+  }
+
+  @Test
+  func traversalStopsAfterTheLastSibling() {
+    let block = Direction(.vertical) {
+      Direction(.horizontal) {
+        Text("a")
+        Text("b")
+      }
+      Text("after")
+    }
+    let layout = Wayland.calculateLayout(block, height: 100, width: 300, settings: Wayland.fontSettings)
+    let nodes = layout.nodes
+    let outer = Array(nodes.children(of: nodes.root))
+    let inner = outer[0]
+    let cells = Array(nodes.children(of: inner))
+
+    var visitor = RecordingVisitor()
+    nodes.traverse(from: cells[0], with: &visitor)
+    // The siblings and their descendants, never the parent or what follows it.
+    #expect(visitor.entered.first == cells[0])
+    #expect(cells.allSatisfy { visitor.entered.contains($0) })
+    #expect(!visitor.entered.contains(outer[1]))
+    #expect(!visitor.exited.contains(inner))
+    #expect(!visitor.exited.contains(nodes.root))
+    #expect(visitor.exited.count == visitor.entered.count)
+  }
 }
@@ -0,0 +1,71 @@
+import Fixtures
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite struct LayoutSnapshotTests {
+
+  func expectEqual(_ layout: Layout, _ serial: Layout) {
+    #expect(layout.nodes.ids.elementsEqual(serial.nodes.ids))
+    #expect(layout.nodes.parent.elementsEqual(serial.nodes.parent))
+    #expect(layout.sizes.elementsEqual(serial.sizes))
+    #expect(layout.positions.elementsEqual(serial.positions) { $0 == $1 })
+  }
+
+  /// Lays out `block` serially on the main actor and from a snapshot, serially
+  /// and in parallel with runs small enough to split even small trees.
+  func expectSnapshotMatches(_ block: some Block) async {
+    let serial = calculateLayout(block, height: 600, width: 800, settings: Wayland.fontSettings)
+    let snapshot = LayoutSnapshot(block, settings: Wayland.fontSettings)
+    #expect(snapshot.count == serial.nodes.count)
+
+    expectEqual(snapshot.layout(height: 600, width: 800), serial)
+    for grain in [1, 3, 16, 1024] {
+      expectEqual(await snapshot.parallelLayout(height: 600, width: 800, grain: grain), serial)
+    }
+  }
+
+  @Test
+  func fixturesMatchSerialLayout() async {
+    await expectSnapshotMatches(Screen(scale: 2, ips: ["1.1.1.1", "10.0.0.2"], fps: "60 FPS"))
+    await expectSnapshotMatches(SystemToolbar(battery: "69%", batteryColor: .pink, time: "time"))
+    await expectSnapshotMatches(SpacingTestComplexNesting())
+    await expectSnapshotMatches(RectTestNested())
+    await expectSnapshotMatches(GrowTestMultipleHorizontal())
+    await expectSnapshotMatches(MixedGrowDemo())
+    await expectSnapshotMatches(EdgeCaseDeepNesting())
+    await expectSnapshotMatches(SpacingTestEmptyGroup())
+  }
+
+  @Test
+  func generatedTreesMatchSerialLayout() async {
+    await expectSnapshotMatches(GeneratedList(rows: 2_000))
+    await expectSnapshotMatches(GeneratedGrid(rows: 40, columns: 20))
+    await expectSnapshotMatches(GeneratedNesting(depth: 200))
+    await expectSnapshotMatches(GeneratedGrowRows(rows: 50, columns: 10))
+  }
+
+  @Test
+  func largeTreeIsSplitIntoRuns() {
+    let snapshot = LayoutSnapshot(GeneratedGrid(rows: 100, columns: 20), settings: Wayland.fontSettings)
+    let (spine, runs) = snapshot.partition(grain: 256)
+    #expect(runs.count > 1)
+    // Every node is either above the runs or inside exactly one of them.
+    let covered = runs.reduce(0) { $0 + $1.range.count }
+    #expect(spine.count + covered == snapshot.count)
+    #expect(runs.allSatisfy { $0.range.count <= 256 })
+  }
+
+  @Test
+  func layoutRunsOffTheMainActor() async {
+    let snapshot = LayoutSnapshot(GeneratedGrid(rows: 100, columns: 20), settings: Wayland.fontSettings)
+    let layout = await Task.detached {
+      await snapshot.parallelLayout(height: 600, width: 800)
+    }.value
+    let serial = calculateLayout(
+      GeneratedGrid(rows: 100, columns: 20), height: 600, width: 800, settings: Wayland.fontSettings)
+    expectEqual(layout, serial)
+  }
+}
@@ -0,0 +1,79 @@
+import Fixtures
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite struct NodeIdTests {
+
+  /// Records the ID of every node it visits.
+  struct IdRecorder: Walker {
+    var currentId: Hash = 0
+    var parentId: Hash = 0
+    var currentIndex: NodeIndex = NodeTable.none
+    var parentIndex: NodeIndex = NodeTable.none
+    var nextIndex: NodeIndex = 0
+    var ids: [Hash] = []
+
+    mutating func before(_ block: some Block) {
+      ids.append(currentId)
+    }
+    mutating func after(_ block: some Block) {}
+    mutating func before(child block: some Block) {}
+    mutating func after(child block: some Block) {}
+  }
+
+  @Test
+  func idsAreUniqueInALargeTree() {
+    var walker = AttributesWalker(checksCollisions: true)
+    GeneratedGrid(rows: 100, columns: 20).walk(with: &walker)
+    #expect(walker.collisions.isEmpty)
+    #expect(Set(walker.nodes.ids).count == walker.nodes.count)
+  }
+
+  @Test
+  func idsAreTheSameEveryWalk() {
+    let block = Screen(scale: 2, ips: ["1.1.1.1"], fps: "60 FPS")
+    var first = IdRecorder()
+    block.walk(with: &first)
+    var second = IdRecorder()
+    block.walk(with: &second)
+    #expect(first.ids == second.ids)
+    #expect(typeId(of: Text.self) == typeId(of: Text.self))
+    #expect(typeId(of: Text.self) != typeId(of: Rect.self))
+  }
+
+  @Test
+  func laterWalksReuseTheFirstPass() {
+    let block = Screen(scale: 2, ips: ["1.1.1.1"], fps: "60 FPS")
+    let layout = calculateLayout(block)
+    var computed = IdRecorder()
+    block.walk(with: &computed)
+
+    let grower = GrowWalker(sizes: layout.sizes, nodes: layout.nodes)
+    var reused = Walkers(grower, IdRecorder())
+    block.walk(with: &reused)
+    let (_, recorder) = reused.walkers
+
+    #expect(recorder.ids.elementsEqual(layout.nodes.ids))
+    #expect(computed.ids.elementsEqual(layout.nodes.ids))
+  }
+
+  @Test
+  func collisionsAreReported() {
+    var walker = AttributesWalker(checksCollisions: true, logLevel: .critical)
+    walker.currentId = 42
+    walker.currentIndex = 0
+    walker.nextIndex = 1
+    walker.before(Text("a"))
+    walker.parentIndex = 0
+    walker.currentIndex = 1
+    walker.nextIndex = 2
+    walker.before(Text("b"))
+
+    #expect(walker.collisions.count == 1)
+    #expect(walker.collisions.first?.first == 0)
+    #expect(walker.collisions.first?.second == 1)
+  }
+}
@@ -13,18 +13,18 @@ import Testing
     let test = PositionTestSimpleHorizontal()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
 
-    var positioner = PositionWalker(sizes: sizer.sizes.convert(), attributes: attributesWalker.attributes)
+    var positioner = PositionWalker(sizes: sizer.sizes.convert(), nodes: attributesWalker.nodes)
     test.walk(with: &positioner)
 
-    let testStruct = attributesWalker.tree[0]![0]
-    let group = attributesWalker.tree[testStruct]![0]
-    let tupleBlock = attributesWalker.tree[group]![0]
+    let testStruct = attributesWalker.nodes.root
+    let group = attributesWalker.nodes.firstChild[testStruct]
+    let tupleBlock = attributesWalker.nodes.firstChild[group]
 
-    let rectIds = attributesWalker.tree[tupleBlock]!
-    let rectPositions = rectIds.map { positioner.positions[$0]! }.sorted { $0.x < $1.x }
+    let rectIds = Array(attributesWalker.nodes.children(of: tupleBlock))
+    let rectPositions = rectIds.map { positioner.positions[$0] }.sorted { $0.x < $1.x }
 
     #expect(rectPositions[0] == (x: 0, y: 0))
     #expect(rectPositions[1] == (x: 10, y: 0))
@@ -38,18 +38,18 @@ import Testing
     let test = PositionTestSimpleVertical()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
 
-    var positioner = PositionWalker(sizes: sizer.sizes.convert(), attributes: attributesWalker.attributes)
+    var positioner = PositionWalker(sizes: sizer.sizes.convert(), nodes: attributesWalker.nodes)
     test.walk(with: &positioner)
 
-    let testStruct = attributesWalker.tree[0]![0]
-    let group = attributesWalker.tree[testStruct]![0]
-    let tupleBlock = attributesWalker.tree[group]![0]
+    let testStruct = attributesWalker.nodes.root
+    let group = attributesWalker.nodes.firstChild[testStruct]
+    let tupleBlock = attributesWalker.nodes.firstChild[group]
 
-    let rectIds = attributesWalker.tree[tupleBlock]!
-    let rectPositions = rectIds.map { positioner.positions[$0]! }.sorted { $0.y < $1.y }
+    let rectIds = Array(attributesWalker.nodes.children(of: tupleBlock))
+    let rectPositions = rectIds.map { positioner.positions[$0] }.sorted { $0.y < $1.y }
 
     #expect(rectPositions[0] == (x: 0, y: 0))
     #expect(rectPositions[1] == (x: 0, y: 10))
@@ -63,11 +63,11 @@ import Testing
     let test = EdgeCaseZeroSize()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let tupleBlock = attributesWalker.tree[testStruct]![0]
-    #expect(sizer.sizes[tupleBlock]! == .known(Container(height: 0, width: 0, orientation: .vertical)))
+    let testStruct = attributesWalker.nodes.root
+    let tupleBlock = attributesWalker.nodes.firstChild[testStruct]
+    #expect(sizer.sizes[tupleBlock] == .known(Container(height: 0, width: 0, orientation: .vertical)))
   }
 
   @Test
@@ -75,15 +75,15 @@ import Testing
     let test = EdgeCaseDeepNesting()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let group1 = attributesWalker.tree[testStruct]![0]
-    let group2 = attributesWalker.tree[group1]![0]
-    let group3 = attributesWalker.tree[group2]![0]
-    let group4 = attributesWalker.tree[group3]![0]
-    let tupleBlock = attributesWalker.tree[group4]![0]
-    if case .known(let container) = sizer.sizes[tupleBlock]! {
+    let testStruct = attributesWalker.nodes.root
+    let group1 = attributesWalker.nodes.firstChild[testStruct]
+    let group2 = attributesWalker.nodes.firstChild[group1]
+    let group3 = attributesWalker.nodes.firstChild[group2]
+    let group4 = attributesWalker.nodes.firstChild[group3]
+    let tupleBlock = attributesWalker.nodes.firstChild[group4]
+    if case .known(let container) = sizer.sizes[tupleBlock] {
       #expect(container.height == 10)
       #expect(container.width == 10)
     }
@@ -94,11 +94,11 @@ import Testing
     let test = EdgeCaseVeryLarge()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let tupleBlock = attributesWalker.tree[testStruct]![0]
-    if case .known(let container) = sizer.sizes[tupleBlock]! {
+    let testStruct = attributesWalker.nodes.root
+    let tupleBlock = attributesWalker.nodes.firstChild[testStruct]
+    if case .known(let container) = sizer.sizes[tupleBlock] {
       #expect(container.width > 0, "Width should be positive for large values")
       #expect(container.height > 0, "Height should be positive for large values")
     }
@@ -119,7 +119,7 @@ import Testing
     let test = OverflowTest()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
 
     #expect(!sizer.sizes.isEmpty, "Should calculate sizes without crashing")
@@ -129,11 +129,11 @@ import Testing
   func leftPaddingTest() {
     let block = LeftPadding()
     let layout = calculateLayout(block)
-    let root = layout.tree[0]![0]
-    let node = layout.tree[root]![0]
-    let n1 = layout.tree[node]![0]
-    let n2 = layout.tree[n1]![1]
-    let c = layout.positions[n2]!
+    let root = layout.nodes.root
+    let node = layout.nodes.firstChild[root]
+    let n1 = layout.nodes.firstChild[node]
+    let n2 = Array(layout.nodes.children(of: n1))[1]
+    let c = layout.positions[n2]
     #expect(c.x == 800 - 29)
   }
 
@@ -141,17 +141,17 @@ import Testing
   func growToolbar() {
     let block = SystemToolbar(battery: "69%", batteryColor: .pink)
     let layout = calculateLayout(block)
-    let root = layout.tree[0]![0]
-    let node = layout.tree[root]![0]
-    let n1 = layout.tree[node]![0]
-    let battery = layout.tree[n1]![0]
-    let b = layout.positions[battery]!
+    let root = layout.nodes.root
+    let node = layout.nodes.firstChild[root]
+    let n1 = layout.nodes.firstChild[node]
+    let battery = layout.nodes.firstChild[n1]
+    let b = layout.positions[battery]
     #expect(b.x == 0)
-    let spacer = layout.tree[n1]![1]
-    let s = layout.positions[spacer]!
+    let spacer = Array(layout.nodes.children(of: n1))[1]
+    let s = layout.positions[spacer]
     #expect(s.x == 34)
-    let clock = layout.tree[n1]![2]
-    let c = layout.positions[clock]!
+    let clock = Array(layout.nodes.children(of: n1))[2]
+    let c = layout.positions[clock]
     #expect(c.x == 800 - 202)
   }
 }
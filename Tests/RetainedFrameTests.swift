@@ -0,0 +1,53 @@
+import Fixtures
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite struct RetainedFrameTests {
+
+  func record(_ block: some Block, height: UInt = 20, width: UInt = 800) -> [RenderCommand] {
+    let layout = Wayland.calculateLayout(block, height: height, width: width, settings: Wayland.fontSettings)
+    FrameRecorder.commands.removeAll()
+    Wayland.renderLayout(block, layout: layout, settings: Wayland.fontSettings, to: FrameRecorder.self)
+    return FrameRecorder.commands
+  }
+
+  @Test
+  func identicalFrameIsSkipped() {
+    var frame = RetainedFrame()
+    var first = record(SystemToolbar(battery: "69%", batteryColor: .pink, time: "12:00"))
+    #expect(!first.isEmpty)
+    #expect(frame.update(&first, width: 800, height: 20))
+
+    var second = record(SystemToolbar(battery: "69%", batteryColor: .pink, time: "12:00"))
+    #expect(!frame.update(&second, width: 800, height: 20))
+  }
+
+  @Test
+  func changedFrameIsPresented() {
+    var frame = RetainedFrame()
+    var first = record(SystemToolbar(battery: "69%", batteryColor: .pink, time: "12:00"))
+    _ = frame.update(&first, width: 800, height: 20)
+
+    var changed = record(SystemToolbar(battery: "69%", batteryColor: .pink, time: "12:01"))
+    #expect(frame.update(&changed, width: 800, height: 20))
+    #expect(frame.commands == record(SystemToolbar(battery: "69%", batteryColor: .pink, time: "12:01")))
+  }
+
+  @Test
+  func resizedOrInvalidatedFrameIsPresented() {
+    var frame = RetainedFrame()
+    let block = SystemToolbar(battery: "69%", batteryColor: .pink, time: "12:00")
+    var commands = record(block)
+    _ = frame.update(&commands, width: 800, height: 20)
+
+    commands = record(block)
+    #expect(frame.update(&commands, width: 1024, height: 20))
+
+    frame.invalidate()
+    commands = record(block)
+    #expect(frame.update(&commands, width: 1024, height: 20))
+  }
+}
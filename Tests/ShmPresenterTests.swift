@@ -0,0 +1,162 @@
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+/// Keeps what a compositor would see: the pool, its buffers and every commit.
+@MainActor
+struct StandInCompositor: ShmCompositor {
+  var pool: ShmPool? = nil
+  var offsets: [Int: Int] = [:]
+  var destroyed: [Int] = []
+  var commits: [(buffer: Int, damage: [DamageRect]?)] = []
+  var size = (width: 0, height: 0)
+
+  mutating func share(_ pool: ShmPool) {
+    self.pool = pool
+    offsets.removeAll()
+  }
+
+  mutating func makeBuffer(offset: Int, width: Int, height: Int) -> Int {
+    let buffer = offsets.count + destroyed.count
+    offsets[buffer] = offset
+    size = (width, height)
+    return buffer
+  }
+
+  mutating func destroy(_ buffer: Int) {
+    destroyed.append(buffer)
+  }
+
+  mutating func attach(_ buffer: Int, damage: [DamageRect]?) {
+    commits.append((buffer, damage))
+  }
+
+  /// The pixels of the last committed buffer, read from the shared memory.
+  func screen() -> [UInt32] {
+    guard let pool, let last = commits.last, let offset = offsets[last.buffer] else { return [] }
+    let pixels = unsafe (pool.memory + offset).assumingMemoryBound(to: UInt32.self)
+    return unsafe Array(UnsafeBufferPointer(start: pixels, count: size.width * size.height))
+  }
+}
+
+/// Frames drawn into the buffers of a stand-in compositor, with a quad moving along one band of rows.
+@MainActor
+struct ShmSession {
+  static let band = DamageRect(x: 0, y: 4, width: 64, height: 4)
+  var size: (width: UInt, height: UInt) = (64, 32)
+  var history = DamageHistory()
+  var presenter = ShmPresenter(compositor: StandInCompositor())
+  /// The whole frame drawn into a canvas of its own, what the screen should show.
+  var expected = SoftwareCanvas()
+  /// What was drawn into the buffer of the last frame.
+  var repainted: [DamageRect]? = nil
+
+  var compositor: StandInCompositor { presenter.compositor }
+
+  /// Draws the quad at `x` into a released buffer and presents it, `false` when none is free.
+  mutating func frame(_ x: UInt) throws -> Bool {
+    let quad = RenderableQuad(dst_p0: (x, 4), dst_p1: (x + 4, 8), color: Color.red.rgb())
+    expected.resize(width: size.width, height: size.height)
+    expected.clear()
+    expected.draw(quad)
+    history.record(presenter.width == Int(size.width) ? [Self.band] : [window])
+
+    guard let target = try presenter.acquire(width: Int(size.width), height: Int(size.height)) else {
+      repainted = nil
+      return false
+    }
+    var canvas = unsafe SoftwareCanvas(width: size.width, height: size.height, memory: target.pixels)
+    let repaint = history.repaint(age: target.age)
+    for rect in repaint ?? [window] {
+      canvas.clip = rect
+      canvas.clear()
+      canvas.draw(quad)
+    }
+    repainted = repaint
+    return presenter.present(history: history)
+  }
+
+  var window: DamageRect {
+    DamageRect(x: 0, y: 0, width: size.width, height: size.height)
+  }
+}
+
+@MainActor
+@Suite struct ShmPresenterTests {
+
+  @Test
+  func buffersAreRecycledOnRelease() throws {
+    var session = ShmSession()
+    // The first frame fills a new buffer, and so does the second while the first is busy.
+    _ = try session.frame(0)
+    _ = try session.frame(8)
+    #expect(session.compositor.commits.map(\.buffer) == [0, 1])
+    #expect(session.repainted == nil)
+    #expect(session.compositor.screen() == session.expected.pixels)
+
+    // Once released the first buffer is two frames behind and only their damage is drawn into it.
+    session.presenter.release(0)
+    _ = try session.frame(16)
+    #expect(session.compositor.commits.map(\.buffer) == [0, 1, 0])
+    #expect(session.repainted == [ShmSession.band])
+    #expect(session.compositor.screen() == session.expected.pixels)
+    #expect(session.compositor.commits.last?.damage == [ShmSession.band])
+  }
+
+  @Test
+  func framesWaitForAReleasedBuffer() throws {
+    var session = ShmSession()
+    for x: UInt in [0, 8, 16] {
+      let presented = try session.frame(x)
+      #expect(presented)
+    }
+    // All three are busy, the frame is left out.
+    let presented = try session.frame(24)
+    #expect(!presented)
+    #expect(session.compositor.commits.count == 3)
+
+    session.presenter.release(1)
+    _ = try session.frame(32)
+    #expect(session.compositor.commits.last?.buffer == 1)
+    #expect(session.compositor.screen() == session.expected.pixels)
+    // The compositor hears about the frame left out as well.
+    #expect(session.compositor.commits.last?.damage == [ShmSession.band])
+  }
+
+  @Test
+  func presentingWithoutAFrameDoesNothing() {
+    var presenter = ShmPresenter(compositor: StandInCompositor())
+    let presented = presenter.present(history: DamageHistory())
+    #expect(!presented)
+    #expect(presenter.compositor.commits.isEmpty)
+  }
+
+  @Test
+  func resizingReplacesThePool() throws {
+    var session = ShmSession()
+    _ = try session.frame(0)
+    session.size = (32, 16)
+    _ = try session.frame(0)
+    #expect(session.compositor.destroyed == [0])
+    #expect(session.compositor.size == (32, 16))
+    #expect(session.compositor.commits.last?.damage == nil)
+    #expect(session.compositor.screen() == session.expected.pixels)
+  }
+
+  @Test
+  func swapchainAges() {
+    var swapchain = ShmSwapchain<Int>()
+    #expect(swapchain.needsBuffer)
+    swapchain.add(0)
+    let first = swapchain.acquire()
+    #expect(first?.index == 0 && first?.age == 0)
+    swapchain.present(0)
+    #expect(swapchain.needsBuffer)
+    swapchain.release(0)
+    #expect(!swapchain.needsBuffer)
+    let second = swapchain.acquire()
+    #expect(second?.index == 0 && second?.age == 1)
+    #expect(swapchain.presentedAge == 1)
+  }
+}
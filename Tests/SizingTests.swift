@@ -13,12 +13,12 @@ import Testing
     let test = RectTestBasic(scale: scale)
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let tupleBlock = attributesWalker.tree[testStruct]![0]
+    let testStruct = attributesWalker.nodes.root
+    let tupleBlock = attributesWalker.nodes.firstChild[testStruct]
     #expect(
-      sizer.sizes[tupleBlock]! == Size.known(Container(height: scale * 50, width: scale * 100, orientation: .vertical)))
+      sizer.sizes[tupleBlock] == Size.known(Container(height: scale * 50, width: scale * 100, orientation: .vertical)))
   }
 
   @Test
@@ -26,16 +26,16 @@ import Testing
     let test = RectTestMultiple()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
 
     // Navigate to the actual group containing the rectangles
-    let testStruct = attributesWalker.tree[0]![0]  // RectTestMultiple
-    let group = attributesWalker.tree[testStruct]![0]  // Group(.horizontal)
-    let tupleBlock = attributesWalker.tree[group]![0]  // _TupleBlock containing rectangles
+    let testStruct = attributesWalker.nodes.root  // RectTestMultiple
+    let group = attributesWalker.nodes.firstChild[testStruct]  // Group(.horizontal)
+    let tupleBlock = attributesWalker.nodes.firstChild[group]  // _TupleBlock containing rectangles
 
     // Width: 50 + 40 + 30 = 120, Height: max(30, 60, 40) = 60
-    if case .known(let container) = sizer.sizes[tupleBlock]! {
+    if case .known(let container) = sizer.sizes[tupleBlock] {
       #expect(container.orientation == .horizontal)
       #expect(container.height == 60)
       #expect(container.width == 120)
@@ -47,13 +47,13 @@ import Testing
     let test = RectTestNested()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let group = attributesWalker.tree[testStruct]![0]
-    let tupleBlock = attributesWalker.tree[group]![0]
+    let testStruct = attributesWalker.nodes.root
+    let group = attributesWalker.nodes.firstChild[testStruct]
+    let tupleBlock = attributesWalker.nodes.firstChild[group]
     // Vertical: 20 + max(30, 30) + 20 = 70, Width: max(100, 60, 100) = 100
-    #expect(sizer.sizes[tupleBlock]! == Size.known(Container(height: 70, width: 100, orientation: .vertical)))
+    #expect(sizer.sizes[tupleBlock] == Size.known(Container(height: 70, width: 100, orientation: .vertical)))
   }
 
   @Test
@@ -61,13 +61,13 @@ import Testing
     let test = RectTestScaled()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let group = attributesWalker.tree[testStruct]![0]
-    let tupleBlock = attributesWalker.tree[group]![0]
+    let testStruct = attributesWalker.nodes.root
+    let group = attributesWalker.nodes.firstChild[testStruct]
+    let tupleBlock = attributesWalker.nodes.firstChild[group]
     // Width: 10 + 10 + 10 = 30, Height: max(10, 10, 10) = 10 (scale is Text-only now)
-    #expect(sizer.sizes[tupleBlock]! == Size.known(Container(height: 10, width: 30, orientation: .horizontal)))
+    #expect(sizer.sizes[tupleBlock] == Size.known(Container(height: 10, width: 30, orientation: .horizontal)))
   }
 
   @Test
@@ -75,12 +75,12 @@ import Testing
     let test = SpacingTestEmptyGroup()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let group = attributesWalker.tree[testStruct]![0]
-    let tupleBlock = attributesWalker.tree[group]![0]
-    #expect(sizer.sizes[tupleBlock]! == Size.known(Container(height: 0, width: 0, orientation: .horizontal)))
+    let testStruct = attributesWalker.nodes.root
+    let group = attributesWalker.nodes.firstChild[testStruct]
+    let tupleBlock = attributesWalker.nodes.firstChild[group]
+    #expect(sizer.sizes[tupleBlock] == Size.known(Container(height: 0, width: 0, orientation: .horizontal)))
   }
 
   @Test
@@ -88,12 +88,12 @@ import Testing
     let test = SpacingTestSingleElement()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let group = attributesWalker.tree[testStruct]![0]
-    let tupleBlock = attributesWalker.tree[group]![0]
-    if case .known(let container) = sizer.sizes[tupleBlock]! {
+    let testStruct = attributesWalker.nodes.root
+    let group = attributesWalker.nodes.firstChild[testStruct]
+    let tupleBlock = attributesWalker.nodes.firstChild[group]
+    if case .known(let container) = sizer.sizes[tupleBlock] {
       #expect(container.height > 0)
       #expect(container.width > 0)
     }
@@ -104,12 +104,12 @@ import Testing
     let test = SpacingTestWordRectMixed(scale: 1)
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let group = attributesWalker.tree[testStruct]![0]
-    let tupleBlock = attributesWalker.tree[group]![0]
-    #expect(sizer.sizes[tupleBlock]! == Size.known(Container(height: 20, width: 78, orientation: .horizontal)))
+    let testStruct = attributesWalker.nodes.root
+    let group = attributesWalker.nodes.firstChild[testStruct]
+    let tupleBlock = attributesWalker.nodes.firstChild[group]
+    #expect(sizer.sizes[tupleBlock] == Size.known(Container(height: 20, width: 78, orientation: .horizontal)))
   }
 
   @Test
@@ -117,13 +117,13 @@ import Testing
     let test = SpacingTestComplexNesting()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let group = attributesWalker.tree[testStruct]![0]
-    let tupleBlock = attributesWalker.tree[group]![0]
+    let testStruct = attributesWalker.nodes.root
+    let group = attributesWalker.nodes.firstChild[testStruct]
+    let tupleBlock = attributesWalker.nodes.firstChild[group]
     // This is a complex test - we mainly verify it doesn't crash and produces reasonable results
-    if case .known(let container) = sizer.sizes[tupleBlock]! {
+    if case .known(let container) = sizer.sizes[tupleBlock] {
       #expect(container.height > 0)
       #expect(container.width > 0)
     }
@@ -134,13 +134,13 @@ import Testing
     let test = SpacingTestLargeGap()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let group = attributesWalker.tree[testStruct]![0]
-    let tupleBlock = attributesWalker.tree[group]![0]
+    let testStruct = attributesWalker.nodes.root
+    let group = attributesWalker.nodes.firstChild[testStruct]
+    let tupleBlock = attributesWalker.nodes.firstChild[group]
     // Width: 5 + 100 + 5 = 110, Height: max(5, 100, 5) = 100
-    #expect(sizer.sizes[tupleBlock]! == Size.known(Container(height: 100, width: 110, orientation: .horizontal)))
+    #expect(sizer.sizes[tupleBlock] == Size.known(Container(height: 100, width: 110, orientation: .horizontal)))
   }
 
   @Test
@@ -149,12 +149,12 @@ import Testing
     let test = RectTestBasic(scale: scale)
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let tupleBlock = attributesWalker.tree[testStruct]![0]
+    let testStruct = attributesWalker.nodes.root
+    let tupleBlock = attributesWalker.nodes.firstChild[testStruct]
 
-    if case .known(let container) = sizer.sizes[tupleBlock]! {
+    if case .known(let container) = sizer.sizes[tupleBlock] {
       #expect(container.height == scale * 50)
       #expect(container.width == scale * 100)
     }
@@ -165,14 +165,14 @@ import Testing
     let test = RectTestScaled()
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
-    let testStruct = attributesWalker.tree[0]![0]
-    let group = attributesWalker.tree[testStruct]![0]
-    let tupleBlock = attributesWalker.tree[group]![0]
+    let testStruct = attributesWalker.nodes.root
+    let group = attributesWalker.nodes.firstChild[testStruct]
+    let tupleBlock = attributesWalker.nodes.firstChild[group]
 
     // Width: 10 + 10 + 10 = 30, Height: max(10, 10, 10) = 10 (scale is Text-only now)
-    if case .known(let container) = sizer.sizes[tupleBlock]! {
+    if case .known(let container) = sizer.sizes[tupleBlock] {
       #expect(container.height == 10)
       #expect(container.width == 30)
     }
@@ -184,13 +184,13 @@ import Testing
 
     var attributesWalker = AttributesWalker()
     block.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     block.walk(with: &sizer)
 
-    let testStruct = attributesWalker.tree[0]![0]
-    let attributedBlock = attributesWalker.tree[testStruct]![0]
+    let testStruct = attributesWalker.nodes.root
+    let attributedBlock = attributesWalker.nodes.firstChild[testStruct]
 
-    if case .known(let container) = sizer.sizes[attributedBlock]! {
+    if case .known(let container) = sizer.sizes[attributedBlock] {
       #expect(container.width == 29 * scale)
       #expect(container.height == 7 * scale)
       #expect(container.orientation == .vertical)
@@ -205,13 +205,13 @@ import Testing
 
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
 
     // Set the root container size (simulating what Wayland.render does)
-    let rootId = attributesWalker.tree[0]![0]
+    let rootId = attributesWalker.nodes.root
     let orientation: Orientation
-    switch sizer.sizes[rootId]! {
+    switch sizer.sizes[rootId] {
     case .known(let container):
       orientation = container.orientation
     case .unknown(let o):
@@ -221,19 +221,16 @@ import Testing
 
     // Apply grow sizing
     let containers = sizer.sizes.convert()
-    var grower = GrowWalker(sizes: containers, attributes: attributesWalker.attributes, tree: attributesWalker.tree)
+    var grower = GrowWalker(sizes: containers, nodes: attributesWalker.nodes)
     test.walk(with: &grower)
 
     // Navigate to the grow element
-    let growElement = attributesWalker.tree[rootId]![0]
+    let growElement = attributesWalker.nodes.firstChild[rootId]
 
     // Verify the grow element fills the container
-    if let grownSize = grower.sizes[growElement] {
-      #expect(grownSize.width == containerWidth)
-      #expect(grownSize.height == containerHeight)
-    } else {
-      Issue.record("Grow element not found in grower.sizes")
-    }
+    let grownSize = grower.sizes[growElement]
+    #expect(grownSize.width == containerWidth)
+    #expect(grownSize.height == containerHeight)
   }
 
   @Test
@@ -242,20 +239,20 @@ import Testing
 
     var attributesWalker = AttributesWalker()
     test.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     test.walk(with: &sizer)
 
     // Set the root container size so the grow element has a known reference frame.
-    let rootId = attributesWalker.tree[0]![0]
+    let rootId = attributesWalker.nodes.root
     sizer.sizes[rootId] = .known(Container(height: 400, width: 800, orientation: .vertical))
 
     let containers = sizer.sizes.convert()
-    var grower = GrowWalker(sizes: containers, attributes: attributesWalker.attributes, tree: attributesWalker.tree)
+    var grower = GrowWalker(sizes: containers, nodes: attributesWalker.nodes)
     test.walk(with: &grower)
 
-    let directionGroup = attributesWalker.tree[rootId]![0]
-    let tupleBlock = attributesWalker.tree[directionGroup]![0]
-    let children = attributesWalker.tree[tupleBlock]!
+    let directionGroup = attributesWalker.nodes.firstChild[rootId]
+    let tupleBlock = attributesWalker.nodes.firstChild[directionGroup]
+    let children = Array(attributesWalker.nodes.children(of: tupleBlock))
 
     guard children.count >= 2 else {
       Issue.record("Expected at least 2 children, got \(children.count)")
@@ -265,20 +262,14 @@ import Testing
     let growRect = children[1]
 
     // Fixed rect keeps its declared 200×100.
-    if let fixedSize = grower.sizes[fixedRect] {
-      #expect(fixedSize.width == 200)
-      #expect(fixedSize.height == 100)
-    } else {
-      Issue.record("Fixed rect not found in grower.sizes")
-    }
+    let fixedSize = grower.sizes[fixedRect]
+    #expect(fixedSize.width == 200)
+    #expect(fixedSize.height == 100)
 
     // In a horizontal container, the grow rect fills the cross-axis (height = parent height = 400)
     // and shares remaining primary-axis space (width = parent width - fixed = 800 - 200 = 600).
-    if let growSize = grower.sizes[growRect] {
-      #expect(growSize.width == 600)
-      #expect(growSize.height == 400)
-    } else {
-      Issue.record("Grow rect not found in grower.sizes")
-    }
+    let growSize = grower.sizes[growRect]
+    #expect(growSize.width == 600)
+    #expect(growSize.height == 400)
   }
 }
@@ -0,0 +1,157 @@
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite struct SoftwareCanvasTests {
+
+  /// The blend of one channel the way the canvas should round it.
+  func blend(_ src: UInt32, _ dst: UInt32, alpha: UInt32) -> UInt32 {
+    UInt32((Double(src * alpha + dst * (255 - alpha)) / 255).rounded())
+  }
+
+  @Test(arguments: [0, 1, 7, 8, 9, 16, 20])
+  func fillRowBlendsEveryLength(_ length: Int) {
+    var canvas = SoftwareCanvas(width: 24, height: 1)
+    canvas.fillRow(0, 0..<24, color: 0xFF10_2030, alpha: 255)
+    canvas.fillRow(0, 2..<2 + length, color: 0x80F0_8040, alpha: 0x80)
+    for x in 0..<24 {
+      let expected: UInt32 =
+        (2..<2 + length).contains(x)
+        ? 0xFF00_0000 | blend(0xF0, 0x10, alpha: 0x80) << 16 | blend(0x80, 0x20, alpha: 0x80) << 8
+          | blend(0x40, 0x30, alpha: 0x80)
+        : 0xFF10_2030
+      #expect(canvas.pixels[x] == expected)
+    }
+  }
+
+  @Test
+  func divideIsExact() {
+    for x in stride(from: UInt32(0), through: 255 * 255, by: 7) {
+      let lanes = SoftwareCanvas.divide255(SIMD8(repeating: x))
+      #expect(lanes[0] == UInt32((Double(x) / 255).rounded()))
+    }
+  }
+
+  @Test
+  func clipKeepsPixelsOutside() {
+    var canvas = SoftwareCanvas(width: 10, height: 10)
+    canvas.clip = DamageRect(x: 2, y: 2, width: 3, height: 3)
+    canvas.draw(RenderableQuad(dst_p0: (0, 0), dst_p1: (10, 10), color: Color.red.rgb()))
+    #expect(canvas.rgbaPixels().pixel(x: 3, y: 3) == (255, 0, 0, 255))
+    #expect(canvas.rgbaPixels().pixel(x: 1, y: 3) == (0, 0, 0, 255))
+    #expect(canvas.rgbaPixels().pixel(x: 5, y: 4) == (0, 0, 0, 255))
+  }
+
+  @Test
+  func textBlitsGlyphs() {
+    var canvas = SoftwareCanvas(width: 40, height: 20)
+    canvas.draw(RenderableText("Hi", at: (x: 0, y: 0), scale: 2, background: Color.blue.rgb()))
+    let pixels = canvas.rgbaPixels()
+    // The top row of "H" is 10001.
+    #expect(pixels.pixel(x: 0, y: 0) == (255, 255, 255, 255))
+    #expect(pixels.pixel(x: 1, y: 1) == (255, 255, 255, 255))
+    #expect(pixels.pixel(x: 2, y: 0) == (0, 0, 255, 255))
+    #expect(pixels.pixel(x: 8, y: 0) == (255, 255, 255, 255))
+    // Its middle row is 11111.
+    #expect(pixels.pixel(x: 4, y: 6) == (255, 255, 255, 255))
+    // Spacing between the glyphs has the background, past the text nothing is drawn.
+    #expect(pixels.pixel(x: 10, y: 0) == (0, 0, 255, 255))
+    #expect(pixels.pixel(x: 30, y: 0) == (0, 0, 0, 255))
+    #expect(pixels.pixel(x: 0, y: 14) == (0, 0, 0, 255))
+  }
+
+  @Test
+  func roundedBorders() {
+    var canvas = SoftwareCanvas(width: 40, height: 40)
+    canvas.draw(
+      RenderableQuad(
+        dst_p0: (0, 0), dst_p1: (40, 40), color: Color.red.rgb(), borderColor: Color.green.rgb(),
+        borderWidth: 4, cornerRadius: 10))
+    let pixels = canvas.rgbaPixels()
+    // Outside the rounded corner.
+    #expect(pixels.pixel(x: 0, y: 0) == (0, 0, 0, 255))
+    #expect(pixels.pixel(x: 39, y: 39) == (0, 0, 0, 255))
+    // On the border, along the sides and around the corner.
+    #expect(pixels.pixel(x: 20, y: 1) == pixels.pixel(x: 1, y: 20))
+    #expect(pixels.pixel(x: 20, y: 1).g > 0 && pixels.pixel(x: 20, y: 1).r == 0)
+    #expect(pixels.pixel(x: 4, y: 4).g > 0)
+    // Inside.
+    #expect(pixels.pixel(x: 20, y: 20) == (255, 0, 0, 255))
+    #expect(pixels.pixel(x: 8, y: 20) == (255, 0, 0, 255))
+  }
+
+  /// `quad` drawn one pixel at a time on black, every pixel shaded, inside the clip of `canvas`.
+  func shadedPixels(_ quad: RenderableQuad, like canvas: SoftwareCanvas) -> [UInt32] {
+    var expected = SoftwareCanvas(width: UInt(canvas.width), height: UInt(canvas.height))
+    let x0 = Int(quad.dst_p0.0)
+    let y0 = Int(quad.dst_p0.1)
+    let size = (Float(quad.dst_p1.0) - Float(x0), Float(quad.dst_p1.1) - Float(y0))
+    for y in y0..<min(Int(quad.dst_p1.1), canvas.height) {
+      for x in x0..<min(Int(quad.dst_p1.0), canvas.width) {
+        if let clip = canvas.clip, !(Int(clip.x)..<Int(clip.x + clip.width)).contains(x) { continue }
+        let (isBorder, coverage) = SoftwareCanvas.shade(
+          Float(x - x0) + 0.5, Float(y - y0) + 0.5, size: size, bw: quad.borderWidth, radius: quad.cornerRadius)
+        guard coverage > 0 else { continue }
+        let color = SoftwareCanvas.argb(isBorder ? quad.borderColor : quad.color)
+        expected.fillRow(y, x..<x + 1, color: color, alpha: UInt32((Float(color >> 24) * coverage).rounded()))
+      }
+    }
+    return expected.pixels
+  }
+
+  func bordered(_ x0: UInt, _ x1: UInt, height: UInt = 20) -> RenderableQuad {
+    RenderableQuad(
+      dst_p0: (x0, 0), dst_p1: (x1, height), color: Color.red.rgb(), borderColor: Color.green.rgb(),
+      borderWidth: 1, cornerRadius: 5)
+  }
+
+  @Test
+  func narrowQuadsAreShadedEverywhere() {
+    // Narrower than the border and corner columns on both sides together.
+    for quad in [bordered(2, 8), bordered(0, 1), bordered(3, 14)] {
+      var canvas = SoftwareCanvas(width: 20, height: 20)
+      canvas.draw(quad)
+      #expect(canvas.pixels == shadedPixels(quad, like: canvas))
+    }
+  }
+
+  @Test
+  func quadsCutByTheCanvasEdge() {
+    var canvas = SoftwareCanvas(width: 20, height: 10)
+    let quad = bordered(16, 40)
+    canvas.draw(quad)
+    #expect(canvas.pixels == shadedPixels(quad, like: canvas))
+  }
+
+  @Test(arguments: [(0, 4), (36, 4), (3, 30)])
+  func quadsCutByTheClip(_ x: UInt, _ width: UInt) {
+    var canvas = SoftwareCanvas(width: 40, height: 20)
+    canvas.clip = DamageRect(x: x, y: 0, width: width, height: 20)
+    let quad = bordered(0, 40)
+    canvas.draw(quad)
+    #expect(canvas.pixels == shadedPixels(quad, like: canvas))
+  }
+
+  @Test
+  func edgePixelsAreCoveredPartially() {
+    let (_, outside) = SoftwareCanvas.shade(0.5, 0.5, size: (40, 40), bw: 2, radius: 10)
+    let (_, inside) = SoftwareCanvas.shade(20, 20, size: (40, 40), bw: 2, radius: 10)
+    // 10 from the center of the corner, half inside the radius.
+    let (isBorder, edge) = SoftwareCanvas.shade(4, 2, size: (40, 40), bw: 2, radius: 10)
+    #expect(outside == 0)
+    #expect(inside == 1)
+    #expect(isBorder)
+    #expect(edge > 0 && edge < 1)
+  }
+
+  @Test
+  func differencesIgnoreAlphaAndTolerance() {
+    let a = Pixels(width: 2, height: 1, rgba: [10, 20, 30, 255, 0, 0, 0, 255])
+    let b = Pixels(width: 2, height: 1, rgba: [12, 20, 30, 0, 0, 0, 9, 255])
+    #expect(a.countDifferences(from: b) == 2)
+    #expect(a.countDifferences(from: b, tolerance: 2) == 1)
+    #expect(a.countDifferences(from: b, tolerance: 9) == 0)
+  }
+}
@@ -0,0 +1,73 @@
+import Testing
+
+@testable import Wayland
+
+@MainActor
+@Suite struct StreamRingTests {
+
+  /// Reserves and fences `counts` one frame at a time, checking that no region
+  /// is handed out while a frame reading any part of it is still in flight.
+  func stream(_ ring: inout StreamRing<Int>, _ counts: [Int]) -> (waits: [Int], grows: Int) {
+    var inFlight: [(range: Range<Int>, fence: Int)] = []
+    var waits: [Int] = []
+    var grows = 0
+    for (frame, count) in counts.enumerated() {
+      let region = ring.reserve(
+        count,
+        wait: { fence in
+          waits.append(fence)
+          inFlight.removeAll { $0.fence <= fence }
+        },
+        drop: { fence in inFlight.removeAll { $0.fence == fence } })
+      if region.grew {
+        grows += 1
+        #expect(inFlight.isEmpty)
+      }
+      let range = region.offset..<region.offset + count
+      #expect(range.upperBound <= ring.capacity)
+      #expect(!inFlight.contains { $0.range.overlaps(range) })
+      ring.commit { frame }
+      inFlight.append((range, frame))
+    }
+    return (waits, grows)
+  }
+
+  @Test
+  func framesInFlightDoNotWait() {
+    var ring = StreamRing<Int>(capacity: 300)
+    let (waits, grows) = stream(&ring, [100, 100, 100])
+    #expect(waits.isEmpty)
+    #expect(grows == 0)
+    #expect(ring.framesPending == 3)
+  }
+
+  @Test
+  func wrappingWaitsForTheOldestFrame() {
+    var ring = StreamRing<Int>(capacity: 300)
+    let (waits, _) = stream(&ring, [100, 100, 100, 100])
+    #expect(waits == [0])
+  }
+
+  @Test
+  func unevenFramesNeverOverwriteFramesInFlight() {
+    var ring = StreamRing<Int>(capacity: 1_000)
+    var generator = SystemRandomNumberGenerator()
+    let counts = (0..<2_000).map { _ in Int.random(in: 1...333, using: &generator) }
+    let (_, grows) = stream(&ring, counts)
+    #expect(grows == 0)
+  }
+
+  @Test
+  func hundredThousandInstancesGrowTheRing() {
+    var batch = FrameBatch()
+    let text = String(repeating: "0123456789", count: 10_000)
+    batch.append(RenderableText(text, at: (x: 0, y: 0), scale: 1), texture: 1)
+    #expect(batch.instances.count == 100_001)
+    #expect(batch.draws.count == 1)
+
+    var ring = StreamRing<Int>(capacity: 3 * 4_000)
+    let (_, grows) = stream(&ring, [4_000, batch.instances.count, batch.instances.count, 4_000, batch.instances.count])
+    #expect(grows == 1)
+    #expect(ring.capacity >= batch.instances.count * StreamRing<Int>.framesInFlight)
+  }
+}
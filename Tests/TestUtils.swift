@@ -27,6 +27,9 @@ enum TestUtils {
     }
   }
 
+  /// Sets up headless rendering once, `false` where there is no EGL to render with.
+  static let headless: Bool = (try? Wayland.setupHeadless(width: 800, height: 600)) != nil
+
   static func render(_ block: some Block, layout: Layout, with renderer: any Renderer.Type)
     -> RenderWalker
   {
@@ -44,21 +47,21 @@ enum TestUtils {
   @MainActor
   enum TreeNavigator {
 
-    static func findChildren(in attributes: AttributesWalker, parentId: Hash) -> [Hash]? {
-      return attributes.tree[parentId]
+    static func findChildren(in attributes: AttributesWalker, parent: NodeIndex) -> [NodeIndex] {
+      return Array(attributes.nodes.children(of: parent))
     }
 
-    static func findNestedChild(in attributes: AttributesWalker, path: [Int]) -> Hash? {
-      var currentId: Hash = 0
+    /// Follows child positions starting below the root node.
+    static func findNestedChild(in attributes: AttributesWalker, path: [Int]) -> NodeIndex? {
+      var current = attributes.nodes.root
       for index in path {
-        guard let children = attributes.tree[currentId],
-          index < children.count
-        else {
+        let children = findChildren(in: attributes, parent: current)
+        guard index < children.count else {
           return nil
         }
-        currentId = children[index]
+        current = children[index]
       }
-      return currentId
+      return current
     }
   }
 
@@ -14,22 +14,19 @@ import Testing
 
     var attributesWalker = AttributesWalker()
     block.walk(with: &attributesWalker)
-    var sizer = SizeWalker(settings: Wayland.fontSettings, attributes: attributesWalker.attributes)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
     block.walk(with: &sizer)
 
-    let rootId = attributesWalker.tree[0]![0]
+    let rootId = attributesWalker.nodes.root
     sizer.sizes[rootId] = .known(Container(height: 400, width: 600, orientation: .vertical))
 
     let containers = sizer.sizes.convert()
-    var grower = GrowWalker(sizes: containers, attributes: attributesWalker.attributes, tree: attributesWalker.tree)
+    var grower = GrowWalker(sizes: containers, nodes: attributesWalker.nodes)
     block.walk(with: &grower)
 
-    let growElement = attributesWalker.tree[rootId]![0]
-    if let grownSize = grower.sizes[growElement] {
-      #expect(grownSize.width == 600)
-      #expect(grownSize.height == 400)
-    } else {
-      Issue.record("Failed to parse tree")
-    }
+    let growElement = attributesWalker.nodes.firstChild[rootId]
+    let grownSize = grower.sizes[growElement]
+    #expect(grownSize.width == 600)
+    #expect(grownSize.height == 400)
   }
 }
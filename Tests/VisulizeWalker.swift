@@ -6,13 +6,16 @@
 struct VisualizeWalker: Walker {
   var currentId: Hash = 0
   var parentId: Hash = 0
+  var currentIndex: NodeIndex = NodeTable.none
+  var parentIndex: NodeIndex = NodeTable.none
+  var nextIndex: NodeIndex = 0
   let layout: Layout
-  var nodeInfo: [Hash: String] = [:]
+  var nodeInfo: [NodeIndex: String] = [:]
 
   func display() -> String {
     var result: [String] = []
     result.append("Tree Structure:")
-    displayTree(rootId: 0, level: 0, result: &result)
+    displayTree(rootId: layout.nodes.root, level: 0, result: &result)
     result.append("")
 
     result.append("Node Details:")
@@ -24,16 +27,14 @@ struct VisualizeWalker: Walker {
     return result.joined(separator: "\n")
   }
 
-  private func displayTree(rootId: Hash, level: Int, result: inout [String]) {
+  private func displayTree(rootId: NodeIndex, level: Int, result: inout [String]) {
     let indent = String(repeating: "  ", count: level)
     if let nodeType = nodeInfo[rootId] {
       result.append("\(indent)[\(rootId): \(nodeType)]")
     }
 
-    if let children = layout.tree[rootId], !children.isEmpty {
-      for childId in children {
-        displayTree(rootId: childId, level: level + 1, result: &result)
-      }
+    for childId in layout.nodes.children(of: rootId) {
+      displayTree(rootId: childId, level: level + 1, result: &result)
     }
   }
 
@@ -42,24 +43,23 @@ struct VisualizeWalker: Walker {
     return "rgb(\(Int(rgb.r * 255)),\(Int(rgb.g * 255)),\(Int(rgb.b * 255)))"
   }
 
-  private func displayNodeInfo(id: Hash, result: inout [String]) {
+  private func displayNodeInfo(id: NodeIndex, result: inout [String]) {
     result.append("\(id): \(nodeInfo[id]!)")
 
-    if let pos = layout.positions[id] {
-      result.append("  Position: (\(pos.x), \(pos.y))")
-    }
+    let pos = layout.positions[id]
+    result.append("  Position: (\(pos.x), \(pos.y))")
 
-    if let container = layout.sizes[id] {
-      result.append("  Size: \(container.width) x \(container.height)")
-      result.append("  Orientation: \(container.orientation)")
-    }
+    let container = layout.sizes[id]
+    result.append("  Size: \(container.width) x \(container.height)")
+    result.append("  Orientation: \(container.orientation)")
 
-    if let attrs = layout.attributes[id] {
+    if let attrs = layout.attributes(at: id) {
       let attrsInfo = attrs.dumpAttributes()
       result.append(attrsInfo)
     }
 
-    if let children = layout.tree[id], !children.isEmpty {
+    let children = Array(layout.nodes.children(of: id))
+    if !children.isEmpty {
       result.append("  Children: [\(children.map(String.init).joined(separator: ", "))]")
     }
   }
@@ -69,7 +69,7 @@ struct VisualizeWalker: Walker {
     if let attributedBlock = block as? AttributedBlock<Text> {
       description += " \"\(attributedBlock.wrapped.label)\""
     }
-    nodeInfo[currentId] = description
+    nodeInfo[currentIndex] = description
   }
   mutating func after(_ block: some Block) {}
   mutating func before(child block: some Block) {}
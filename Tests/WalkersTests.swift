@@ -0,0 +1,61 @@
+import Fixtures
+import Testing
+
+@testable import ShapeTree
+@testable import Wayland
+
+@MainActor
+@Suite struct WalkersTests {
+
+  @Test
+  func fusedWalkMatchesSeparateWalks() {
+    let block = Screen(scale: 2, ips: ["1.1.1.1"], fps: "60 FPS")
+
+    var attributesWalker = AttributesWalker()
+    block.walk(with: &attributesWalker)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
+    block.walk(with: &sizer)
+
+    var fused = Walkers(AttributesWalker(), SizeWalker(settings: Wayland.fontSettings))
+    block.walk(with: &fused)
+    let (fusedAttributes, fusedSizer) = fused.walkers
+
+    #expect(fusedAttributes.nodes.ids.elementsEqual(attributesWalker.nodes.ids))
+    #expect(fusedAttributes.nodes.parent.elementsEqual(attributesWalker.nodes.parent))
+    #expect(fusedSizer.sizes.elementsEqual(sizer.sizes))
+  }
+
+  @Test
+  func layoutMatchesSeparateWalks() {
+    let block = SystemToolbar(battery: "69%", batteryColor: .pink, time: "time")
+    let layout = calculateLayout(block)
+
+    var attributesWalker = AttributesWalker()
+    block.walk(with: &attributesWalker)
+    var sizer = SizeWalker(settings: Wayland.fontSettings)
+    block.walk(with: &sizer)
+    let root = attributesWalker.nodes.root
+    sizer.sizes[root] = .known(
+      Container(height: Wayland.windowHeight, width: Wayland.windowWidth, orientation: .vertical))
+    var grower = GrowWalker(sizes: sizer.sizes.convert(), nodes: attributesWalker.nodes)
+    block.walk(with: &grower)
+    var positioner = PositionWalker(sizes: grower.sizes, nodes: attributesWalker.nodes)
+    block.walk(with: &positioner)
+
+    #expect(layout.sizes.elementsEqual(grower.sizes))
+    #expect(layout.positions.elementsEqual(positioner.positions) { $0 == $1 })
+  }
+
+  @Test
+  func copiesWalkOnTheirOwn() {
+    let block = SystemToolbar(battery: "69%", batteryColor: .pink, time: "time")
+    let fresh = Walkers(AttributesWalker())
+    var walked = fresh
+    block.walk(with: &walked)
+    let walkedAttributes = walked.walkers
+    let freshAttributes = fresh.walkers
+
+    #expect(walkedAttributes.nodes.count > 0)
+    #expect(freshAttributes.nodes.count == 0)
+  }
+}
@@ -6,14 +6,14 @@
 layout(location=0) in vec2 a_quad;    // [-1,1] corners - defines which vertex of the quad we're processing
 layout(location=1) in vec2 i_dst_p0;  // pixel-space top-left - rectangle's top-left corner in screen pixels
 layout(location=2) in vec2 i_dst_p1;  // pixel-space bottom-right - rectangle's bottom-right corner in screen pixels
-layout(location=3) in vec2 i_src_p0;  // UV-space top-left - texture coordinates (usually 0,0)
-layout(location=4) in vec2 i_src_p1;  // UV-space bottom-right - texture coordinates (usually 1,1)
-layout(location=5) in vec4 i_color;  // Main rectangle color
-layout(location=6) in vec4 i_border_color;  // Border color (rgba) - optimized: could be removed later
-layout(location=7) in float i_border_width;  // Border width in pixels - optimized: could be removed later
-layout(location=8) in float i_corner_radius;  // Corner radius in pixels
+layout(location=3) in float i_glyph;  // Glyph cell in the font atlas, 65535 for quads without a glyph
+layout(location=4) in vec4 i_color;  // Main rectangle color
+layout(location=5) in vec4 i_border_color;  // Border color (rgba)
+layout(location=6) in vec2 i_border;  // Border width and corner radius in pixels
 
 uniform vec2 uRes;  // Screen resolution (width, height) for coordinate conversion
+uniform vec4 uGlyph;  // Distance between glyph cells and glyph width along u, then top and bottom v
+uniform vec2 uWhite;  // UV of the white texels quads without a glyph sample
 
 // === OPTIMIZED INTERPOLATING VALUES ===
 // These values are interpolated across the quad by GPU hardware (free linear interpolation)
@@ -55,14 +55,19 @@ void main() {
     // === INTERPOLATING VALUES SETUP ===
     // These values will be automatically interpolated across the quad by GPU
 
-    // UV coordinates for texture sampling (interpolated)
-    v_uv = mix(i_src_p0, i_src_p1, t);
+    // UV coordinates for texture sampling (interpolated), looked up from the glyph cell
+    if (i_glyph == 65535.0) {
+        v_uv = uWhite;
+    } else {
+        float u0 = i_glyph * uGlyph.x;
+        v_uv = mix(vec2(u0, uGlyph.z), vec2(u0 + uGlyph.y, uGlyph.w), t);
+    }
 
     // Colors (flat qualifiers tell GPU not to interpolate, saving cycles)
     v_color = i_color;
     v_border_color = i_border_color;
-    v_border_width = i_border_width;
-    v_corner_radius = i_corner_radius;
+    v_border_width = i_border.x;
+    v_corner_radius = i_border.y;
 
     // Rectangle dimensions (flat - same for all vertices)
     v_dst_size = i_dst_p1 - i_dst_p0;